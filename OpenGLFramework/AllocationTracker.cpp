@@ -0,0 +1,96 @@
+//
+//  AllocationTracker.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "AllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// constant initialised so allocations from other static constructors are counted too
+static std::atomic<unsigned long long> s_Allocations(0);
+static std::atomic<unsigned long long> s_AllocatedBytes(0);
+static std::atomic<unsigned long long> s_Frees(0);
+
+unsigned long long AllocationTracker::GetAllocations()
+{
+  return s_Allocations.load(std::memory_order_relaxed);
+}
+
+unsigned long long AllocationTracker::GetAllocatedBytes()
+{
+  return s_AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+unsigned long long AllocationTracker::GetFrees()
+{
+  return s_Frees.load(std::memory_order_relaxed);
+}
+
+#ifndef NO_ALLOCATION_TRACKING
+
+bool AllocationTracker::IsEnabled()
+{
+  return true;
+}
+
+static void* TrackedAllocate(std::size_t size)
+{
+  s_Allocations.fetch_add(1, std::memory_order_relaxed);
+  s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  
+  if (size == 0) size = 1;
+  
+//  same as the standard one - give the new handler a chance to free something up
+  while (true)
+  {
+    if (void *pointer = std::malloc(size)) return pointer;
+    
+    std::new_handler handler = std::get_new_handler();
+    if (!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+
+static void TrackedFree(void *pointer)
+{
+  if (!pointer) return;
+  
+  s_Frees.fetch_add(1, std::memory_order_relaxed);
+  std::free(pointer);
+}
+
+void* operator new(std::size_t size) { return TrackedAllocate(size); }
+void* operator new[](std::size_t size) { return TrackedAllocate(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  try { return TrackedAllocate(size); }
+  catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  try { return TrackedAllocate(size); }
+  catch (...) { return nullptr; }
+}
+
+void operator delete(void *pointer) noexcept { TrackedFree(pointer); }
+void operator delete[](void *pointer) noexcept { TrackedFree(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { TrackedFree(pointer); }
+void operator delete(void *pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t&) noexcept { TrackedFree(pointer); }
+
+#else
+
+bool AllocationTracker::IsEnabled()
+{
+  return false;
+}
+
+#endif
@@ -0,0 +1,29 @@
+//
+//  AllocationTracker.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef AllocationTracker_hpp
+#define AllocationTracker_hpp
+
+#include <stdio.h>
+
+/**
+ * counts every heap allocation in the program through a replacement of the global operator new / delete
+ * take the counts at the start and end of a frame to get the allocations per frame, see RenderQueue::BeginFrame
+ *
+ * define NO_ALLOCATION_TRACKING to keep the standard operator new
+ */
+class AllocationTracker
+{
+public:
+  static unsigned long long GetAllocations();
+  static unsigned long long GetAllocatedBytes();
+  static unsigned long long GetFrees();
+  
+  static bool IsEnabled();
+};
+
+#endif /* AllocationTracker_hpp */
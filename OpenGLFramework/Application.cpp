@@ -16,6 +16,7 @@
 #include "imgui_impl_opengl3.h"
 
 #include "Renderer.h"
+#include "RenderQueue.hpp"
 
 #include "VertexBuffer.hpp"
 #include "IndexBuffer.hpp"
@@ -138,12 +139,16 @@ int main(void)
     shader.Unbind();
     
     Renderer renderer;
+    RenderQueue queue;
     
     float redChannel = 0.0f;
     float increment = 0.05f;
+    double lastReport = 0.0;
     /* Loop until the user closes the window */
     while (!glfwWindowShouldClose(window))
     {
+      queue.BeginFrame();
+      
       /* Render here */
       renderer.Clear();
       
@@ -153,10 +158,8 @@ int main(void)
       //    pass down the colour dynamically
       shader.SetUniform4f("u_Color", redChannel, 0.3f, 0.8f, 1.0f);
       
-      renderer.Draw(va, ib, shader);
-      
-      //    draw the triangle specified - draw call
-      GLCall(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr));
+//      queued and drawn in EndFrame, it sets u_MVP for us
+      queue.Submit(va, ib, shader, mvp);
       
       //    Animate the colour
       if (redChannel > 1.0f)
@@ -171,6 +174,18 @@ int main(void)
       
       glEnd();
       
+      queue.EndFrame();
+      
+//      heap allocations of the last frame in the title once a second
+//      building the string allocates too so it stays outside BeginFrame / EndFrame
+      if (glfwGetTime() - lastReport >= 1.0)
+      {
+        const RenderQueueStatistics &stats = queue.GetStatistics();
+        std::string title = "Hello World - " + std::to_string(stats.allocations) + " allocations, " + std::to_string(stats.allocatedBytes) + " bytes per frame";
+        glfwSetWindowTitle(window, title.c_str());
+        lastReport = glfwGetTime();
+      }
+      
       
       /* Swap front and back buffers */
       glfwSwapBuffers(window);
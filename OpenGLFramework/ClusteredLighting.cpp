@@ -0,0 +1,66 @@
+//
+//  ClusteredLighting.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "ClusteredLighting.hpp"
+
+#include "Renderer.h"
+#include "Shader.hpp"
+
+ClusteredLighting::ClusteredLighting(unsigned int tilesX, unsigned int tilesY, unsigned int slices)
+: m_Builder(tilesX, tilesY, slices),
+  m_ClusterBuffer(GL_RG32UI, tilesX * tilesY * slices * sizeof(LightCluster)),
+  m_IndexBuffer(GL_R32UI, 64 * 1024 * sizeof(unsigned int)),
+  m_LightBuffer(GL_RGBA32F, 1024 * 2 * sizeof(glm::vec4))
+{
+}
+
+void ClusteredLighting::SetProjection(float fovY, float aspect, float nearPlane, float farPlane)
+{
+  m_Builder.SetProjection(fovY, aspect, nearPlane, farPlane);
+}
+
+void ClusteredLighting::Update(const std::vector<PointLight> &lights, const glm::mat4 &view)
+{
+  m_Builder.Build(lights, view);
+  
+//  the builder already moved the lights to view space
+  const auto &x = m_Builder.GetViewLightX();
+  const auto &y = m_Builder.GetViewLightY();
+  const auto &depth = m_Builder.GetViewLightZ();
+  
+  m_LightData.resize(lights.size() * 2);
+  for (unsigned int i = 0; i < lights.size(); i++)
+  {
+    const PointLight &light = lights[i];
+    
+    m_LightData[i * 2 + 0] = glm::vec4(x[i], y[i], -depth[i], light.radius);
+    m_LightData[i * 2 + 1] = glm::vec4(light.color * light.intensity, 1.0f);
+  }
+  
+  const auto &clusters = m_Builder.GetClusters();
+  const auto &indices = m_Builder.GetLightIndices();
+  
+  m_ClusterBuffer.SetData(clusters.data(), (unsigned int)(clusters.size() * sizeof(LightCluster)));
+  if (!indices.empty()) m_IndexBuffer.SetData(indices.data(), (unsigned int)(indices.size() * sizeof(unsigned int)));
+  if (!m_LightData.empty()) m_LightBuffer.SetData(m_LightData.data(), (unsigned int)(m_LightData.size() * sizeof(glm::vec4)));
+}
+
+void ClusteredLighting::Bind(Shader &shader, int screenWidth, int screenHeight, unsigned int firstSlot) const
+{
+  m_ClusterBuffer.Bind(firstSlot);
+  m_IndexBuffer.Bind(firstSlot + 1);
+  m_LightBuffer.Bind(firstSlot + 2);
+  
+  shader.Bind();
+  shader.SetUniform1i("u_Clusters", firstSlot);
+  shader.SetUniform1i("u_LightIndices", firstSlot + 1);
+  shader.SetUniform1i("u_Lights", firstSlot + 2);
+  shader.SetUniform3f("u_ClusterGrid", (float)m_Builder.GetTilesX(), (float)m_Builder.GetTilesY(), (float)m_Builder.GetSlices());
+  shader.SetUniform2f("u_ScreenSize", (float)screenWidth, (float)screenHeight);
+  shader.SetUniform1f("u_Near", m_Builder.GetNear());
+  shader.SetUniform1f("u_Far", m_Builder.GetFar());
+}
@@ -0,0 +1,61 @@
+//
+//  ClusteredLighting.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef ClusteredLighting_hpp
+#define ClusteredLighting_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "LightClusterBuilder.hpp"
+#include "TextureBuffer.hpp"
+
+class Shader;
+
+/**
+ * clustered forward shading for res/shaders/Lit.shader
+ * LightClusterBuilder assigns the lights and the results go up as three buffer textures
+ *   clusters        RG32UI   - offset and count into the index list
+ *   light indices   R32UI
+ *   lights          RGBA32F  - 2 texels each, view space position + radius then colour * intensity
+ */
+class ClusteredLighting
+{
+private:
+  LightClusterBuilder m_Builder;
+  
+  TextureBuffer m_ClusterBuffer;
+  TextureBuffer m_IndexBuffer;
+  TextureBuffer m_LightBuffer;
+  
+  std::vector<glm::vec4> m_LightData;
+  
+public:
+  ClusteredLighting(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24);
+  
+  /**
+   * has to match the projection the scene is drawn with
+   */
+  void SetProjection(float fovY, float aspect, float nearPlane, float farPlane);
+  
+  /**
+   * assign the lights and upload everything - once per frame after the camera moved
+   */
+  void Update(const std::vector<PointLight> &lights, const glm::mat4 &view);
+  
+  /**
+   * binds the buffer textures to firstSlot, firstSlot + 1, firstSlot + 2 and sets the cluster uniforms
+   * slot 0 is left for u_Texture
+   */
+  void Bind(Shader &shader, int screenWidth, int screenHeight, unsigned int firstSlot = 1) const;
+  
+  inline const LightClusterBuilder& GetBuilder() const { return m_Builder; }
+};
+
+#endif /* ClusteredLighting_hpp */
@@ -0,0 +1,142 @@
+//
+//  Font.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "Font.hpp"
+
+#include <iostream>
+
+#include "vendor/stb_image/stb_image.h"
+
+BitmapFontRasterizer::BitmapFontRasterizer(const std::string &path, int columns, int rows, unsigned int firstCodepoint)
+: m_Width(0), m_Height(0), m_Columns(columns), m_Rows(rows), m_CellWidth(0), m_CellHeight(0), m_FirstCodepoint(firstCodepoint)
+{
+//  keep the rows top down, the atlas flips them when it writes the distance field
+  stbi_set_flip_vertically_on_load(0);
+  
+  int bpp = 0;
+  unsigned char *image = stbi_load(path.c_str(), &m_Width, &m_Height, &bpp, 4);
+  if (!image)
+  {
+    std::cout << "Failed to load font sheet " << path << std::endl;
+    return;
+  }
+  
+  m_CellWidth = m_Width / columns;
+  m_CellHeight = m_Height / rows;
+  
+  bool opaque = true;
+  for (int i = 0; i < m_Width * m_Height && opaque; i++)
+  {
+    opaque = image[i * 4 + 3] == 255;
+  }
+  
+  m_Coverage.resize(m_Width * m_Height);
+  for (int i = 0; i < m_Width * m_Height; i++)
+  {
+    m_Coverage[i] = opaque ? image[i * 4] : image[i * 4 + 3];
+  }
+  
+  stbi_image_free(image);
+  
+//  blank cells like space only need the advance
+  m_Blank.resize(columns * rows);
+  for (unsigned int cell = 0; cell < m_Blank.size(); cell++)
+  {
+    const int cellX = (cell % m_Columns) * m_CellWidth;
+    const int cellY = (cell / m_Columns) * m_CellHeight;
+    
+    bool blank = true;
+    for (int y = 0; y < m_CellHeight && blank; y++)
+    {
+      for (int x = 0; x < m_CellWidth && blank; x++)
+      {
+        blank = m_Coverage[(cellY + y) * m_Width + cellX + x] < 128;
+      }
+    }
+    m_Blank[cell] = blank;
+  }
+}
+
+bool BitmapFontRasterizer::GetMetrics(unsigned int codepoint, GlyphBitmap &out)
+{
+  if (m_Coverage.empty() || codepoint < m_FirstCodepoint) return false;
+  
+  unsigned int cell = codepoint - m_FirstCodepoint;
+  if (cell >= m_Blank.size()) return false;
+  
+  out.width = m_Blank[cell] ? 0 : m_CellWidth;
+  out.height = m_Blank[cell] ? 0 : m_CellHeight;
+  out.bearingX = 0.0f;
+  out.bearingY = (float)m_CellHeight;
+  out.advance = (float)m_CellWidth;
+  return true;
+}
+
+bool BitmapFontRasterizer::Rasterize(unsigned int codepoint, GlyphBitmap &out)
+{
+  if (!GetMetrics(codepoint, out)) return false;
+  if (out.width == 0) return true;
+  
+  unsigned int cell = codepoint - m_FirstCodepoint;
+  const int cellX = (cell % m_Columns) * m_CellWidth;
+  const int cellY = (cell / m_Columns) * m_CellHeight;
+  
+  out.pixels.resize(m_CellWidth * m_CellHeight);
+  for (int y = 0; y < m_CellHeight; y++)
+  {
+    for (int x = 0; x < m_CellWidth; x++)
+    {
+      out.pixels[y * m_CellWidth + x] = m_Coverage[(cellY + y) * m_Width + cellX + x];
+    }
+  }
+  
+  return true;
+}
+
+
+Font::Font(std::unique_ptr<GlyphRasterizer> rasterizer, int atlasSize, int slotSize, int spread)
+: m_Rasterizer(std::move(rasterizer)), m_Atlas(atlasSize, atlasSize, slotSize, spread)
+{
+}
+
+unsigned int Font::Layout(const std::string &text, float x, float y, float scale, unsigned int color, std::vector<TextVertex> &out)
+{
+  float penX = x;
+  float penY = y;
+  unsigned int glyphs = 0;
+  
+  for (unsigned char c : text)
+  {
+    if (c == '\n')
+    {
+      penX = x;
+      penY -= m_Rasterizer->GetLineHeight() * scale;
+      continue;
+    }
+    
+    const AtlasGlyph *glyph = m_Atlas.GetGlyph(c, *m_Rasterizer);
+    if (!glyph) continue;
+    
+    if (glyph->width > 0.0f)
+    {
+      float x0 = penX + glyph->offsetX * scale;
+      float y0 = penY + glyph->offsetY * scale;
+      float x1 = x0 + glyph->width * scale;
+      float y1 = y0 + glyph->height * scale;
+      
+      out.push_back({ x0, y0, glyph->uv.x, glyph->uv.y, color });
+      out.push_back({ x1, y0, glyph->uv.z, glyph->uv.y, color });
+      out.push_back({ x1, y1, glyph->uv.z, glyph->uv.w, color });
+      out.push_back({ x0, y1, glyph->uv.x, glyph->uv.w, color });
+      glyphs++;
+    }
+    
+    penX += glyph->advance * scale;
+  }
+  
+  return glyphs;
+}
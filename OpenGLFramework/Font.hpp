@@ -0,0 +1,80 @@
+//
+//  Font.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef Font_hpp
+#define Font_hpp
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GlyphAtlas.hpp"
+
+/**
+ * reads glyphs out of a monospaced font sheet - an image split into a grid of equal cells
+ * the first cell is firstCodepoint and they go left to right, top to bottom
+ * alpha is used as coverage, or the red channel if the sheet is fully opaque
+ * the baseline is the bottom of the cell
+ */
+class BitmapFontRasterizer : public GlyphRasterizer
+{
+private:
+  std::vector<unsigned char> m_Coverage;
+  std::vector<bool> m_Blank;    // per cell, found once when the sheet is loaded
+  int m_Width, m_Height;
+  int m_Columns, m_Rows;
+  int m_CellWidth, m_CellHeight;
+  unsigned int m_FirstCodepoint;
+  
+public:
+  BitmapFontRasterizer(const std::string &path, int columns = 16, int rows = 16, unsigned int firstCodepoint = 0);
+  
+  bool Rasterize(unsigned int codepoint, GlyphBitmap &out) override;
+  bool GetMetrics(unsigned int codepoint, GlyphBitmap &out) override;
+  inline float GetLineHeight() const override { return (float)m_CellHeight; }
+};
+
+/**
+ * what TextRenderer streams per glyph corner
+ */
+struct TextVertex
+{
+  float x, y;
+  float u, v;
+  unsigned int color;   // RGBA8, red in the lowest byte
+};
+
+/**
+ * a glyph source plus the distance field atlas it is cached in
+ * CPU only - TextRenderer owns the atlas texture
+ */
+class Font
+{
+private:
+  std::unique_ptr<GlyphRasterizer> m_Rasterizer;
+  GlyphAtlas m_Atlas;
+  
+public:
+  /**
+   * slotSize has to fit the largest glyph plus spread pixels on every side
+   */
+  Font(std::unique_ptr<GlyphRasterizer> rasterizer, int atlasSize = 1024, int slotSize = 64, int spread = 8);
+  
+  /**
+   * appends 4 vertices per visible glyph to out, x and y is the pen on the baseline
+   * \n starts a new line below
+   * returns the number of glyphs added
+   */
+  unsigned int Layout(const std::string &text, float x, float y, float scale, unsigned int color, std::vector<TextVertex> &out);
+  
+  inline GlyphAtlas& GetAtlas() { return m_Atlas; }
+  inline const GlyphAtlas& GetAtlas() const { return m_Atlas; }
+  inline float GetLineHeight() const { return m_Rasterizer->GetLineHeight(); }
+};
+
+#endif /* Font_hpp */
@@ -0,0 +1,82 @@
+//
+//  FrameAllocator.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "FrameAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameAllocator::FrameAllocator(size_t capacity)
+: m_Buffer(static_cast<unsigned char*>(::operator new(capacity))), m_Capacity(capacity), m_Offset(0),
+  m_Overflow(nullptr), m_OverflowBytes(0), m_Peak(0)
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+  FreeOverflow();
+  ::operator delete(m_Buffer);
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+//  align the address rather than the offset, operator new only promises max_align_t
+  const uintptr_t base = reinterpret_cast<uintptr_t>(m_Buffer);
+  const size_t offset = AlignUp(base + m_Offset, alignment) - base;
+  
+  if (offset + size <= m_Capacity)
+  {
+    m_Offset = offset + size;
+    return m_Buffer + offset;
+  }
+  
+//  out of room this frame, a block of its own with the link in front
+  const size_t header = AlignUp(sizeof(OverflowBlock), alignment);
+  unsigned char *memory = static_cast<unsigned char*>(::operator new(header + size + alignment));
+  
+  OverflowBlock *block = reinterpret_cast<OverflowBlock*>(memory);
+  block->next = m_Overflow;
+  m_Overflow = block;
+  m_OverflowBytes += size + alignment;
+  
+  const uintptr_t start = AlignUp(reinterpret_cast<uintptr_t>(memory) + header, alignment);
+  return reinterpret_cast<void*>(start);
+}
+
+void FrameAllocator::Reset()
+{
+  m_Peak = std::max(m_Peak, GetUsed());
+  
+  const bool overflowed = m_Overflow != nullptr;
+  FreeOverflow();
+  
+//  it ran over, make room for the biggest frame seen with some slack
+  if (overflowed)
+  {
+    ::operator delete(m_Buffer);
+    m_Capacity = m_Peak + m_Peak / 2;
+    m_Buffer = static_cast<unsigned char*>(::operator new(m_Capacity));
+  }
+  
+  m_Offset = 0;
+  m_OverflowBytes = 0;
+}
+
+void FrameAllocator::FreeOverflow()
+{
+  while (m_Overflow)
+  {
+    OverflowBlock *next = m_Overflow->next;
+    ::operator delete(m_Overflow);
+    m_Overflow = next;
+  }
+}
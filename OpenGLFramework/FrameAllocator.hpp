@@ -0,0 +1,129 @@
+//
+//  FrameAllocator.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef FrameAllocator_hpp
+#define FrameAllocator_hpp
+
+#include <stdio.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/**
+ * linear arena for data that only lives for one frame - command lists, sort keys, per draw uniforms
+ * allocating is a pointer bump and Reset throws everything away at once, nothing is destructed
+ *
+ * when a frame needs more than the capacity the rest goes in overflow blocks and the next Reset
+ * grows the arena to the peak, so after a few frames it stops touching the heap
+ */
+class FrameAllocator
+{
+private:
+//  chained through the first bytes of each overflow block
+  struct OverflowBlock
+  {
+    OverflowBlock *next;
+  };
+  
+  unsigned char *m_Buffer;
+  size_t m_Capacity;
+  size_t m_Offset;
+  
+  OverflowBlock *m_Overflow;
+  size_t m_OverflowBytes;
+  size_t m_Peak;          // most used in a single frame, overflow included
+  
+public:
+  FrameAllocator(size_t capacity = 1024 * 1024);
+  ~FrameAllocator();
+  
+  FrameAllocator(const FrameAllocator&) = delete;
+  FrameAllocator& operator=(const FrameAllocator&) = delete;
+  
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+  
+  /**
+   * count default constructed Ts, they are never destructed so T cant own anything
+   */
+  template<typename T>
+  T* Allocate(size_t count = 1)
+  {
+    static_assert(std::is_trivially_destructible<T>::value, "frame allocations are never destructed");
+    
+    T *data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    for (size_t i = 0; i < count; i++) new (data + i) T();
+    return data;
+  }
+  
+  /**
+   * everything allocated since the last Reset is gone after this
+   */
+  void Reset();
+  
+  inline size_t GetUsed() const { return m_Offset + m_OverflowBytes; }
+  inline size_t GetCapacity() const { return m_Capacity; }
+  inline size_t GetPeak() const { return m_Peak; }
+  
+private:
+  void FreeOverflow();
+};
+
+
+/**
+ * growable array in a FrameAllocator, growing copies into a new block and leaves the old one until the Reset
+ * elements are never destructed, same as FrameAllocator::Allocate
+ */
+template<typename T>
+class FrameArray
+{
+private:
+  FrameAllocator *m_Allocator;
+  T *m_Data;
+  unsigned int m_Size;
+  unsigned int m_Capacity;
+  
+public:
+  FrameArray()
+  : m_Allocator(nullptr), m_Data(nullptr), m_Size(0), m_Capacity(0)
+  {
+  }
+  
+  FrameArray(FrameAllocator &allocator, unsigned int capacity = 64)
+  : m_Allocator(&allocator), m_Size(0), m_Capacity(capacity)
+  {
+    static_assert(std::is_trivially_destructible<T>::value, "frame allocations are never destructed");
+    m_Data = static_cast<T*>(allocator.Allocate(sizeof(T) * capacity, alignof(T)));
+  }
+  
+  void Push(const T &value)
+  {
+    if (m_Size == m_Capacity)
+    {
+      const unsigned int capacity = m_Capacity ? m_Capacity * 2 : 64;
+      T *data = static_cast<T*>(m_Allocator->Allocate(sizeof(T) * capacity, alignof(T)));
+      for (unsigned int i = 0; i < m_Size; i++) new (data + i) T(m_Data[i]);
+      
+      m_Data = data;
+      m_Capacity = capacity;
+    }
+    
+    new (m_Data + m_Size++) T(value);
+  }
+  
+  inline T& operator[](unsigned int i) { return m_Data[i]; }
+  inline const T& operator[](unsigned int i) const { return m_Data[i]; }
+  
+  inline T* begin() { return m_Data; }
+  inline T* end() { return m_Data + m_Size; }
+  inline const T* begin() const { return m_Data; }
+  inline const T* end() const { return m_Data + m_Size; }
+  
+  inline unsigned int GetSize() const { return m_Size; }
+  inline bool IsEmpty() const { return m_Size == 0; }
+};
+
+#endif /* FrameAllocator_hpp */
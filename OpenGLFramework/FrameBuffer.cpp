@@ -0,0 +1,75 @@
+//
+//  FrameBuffer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "FrameBuffer.hpp"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "Texture.hpp"
+
+static const unsigned int MAX_COLOR_ATTACHMENTS = 8;
+
+FrameBuffer::FrameBuffer()
+: m_ColorAttachments(0)
+{
+  GLCall(glGenFramebuffers(1, &m_RendererID));
+}
+
+FrameBuffer::~FrameBuffer()
+{
+  GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void FrameBuffer::AttachColor(const Texture &texture)
+{
+//  the draw buffer list below and the driver both have a limit, anything past it is left off
+  GLint maxDrawBuffers = 0;
+  GLCall(glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers));
+  const unsigned int limit = std::min(MAX_COLOR_ATTACHMENTS, (unsigned int)maxDrawBuffers);
+  ASSERT(m_ColorAttachments < limit);
+  if (m_ColorAttachments >= limit) return;
+  
+  Bind();
+  GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + m_ColorAttachments, GL_TEXTURE_2D, texture.GetRendererID(), 0));
+  m_ColorAttachments++;
+  
+//  tell GL we draw to every colour attachment, in order
+  GLenum buffers[MAX_COLOR_ATTACHMENTS];
+  for (unsigned int i = 0; i < m_ColorAttachments; i++) buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+  GLCall(glDrawBuffers(m_ColorAttachments, buffers));
+}
+
+void FrameBuffer::AttachDepth(const Texture &texture)
+{
+  Bind();
+  GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture.GetRendererID(), 0));
+  
+//  depth only, e.g. shadow maps
+  if (m_ColorAttachments == 0)
+  {
+    GLCall(glDrawBuffer(GL_NONE));
+    GLCall(glReadBuffer(GL_NONE));
+  }
+}
+
+bool FrameBuffer::IsComplete() const
+{
+  Bind();
+  GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+  return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void FrameBuffer::Bind() const
+{
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+}
+
+void FrameBuffer::Unbind() const
+{
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
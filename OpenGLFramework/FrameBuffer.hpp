@@ -0,0 +1,42 @@
+//
+//  FrameBuffer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef FrameBuffer_hpp
+#define FrameBuffer_hpp
+
+#include <stdio.h>
+
+class Texture;
+
+/**
+ * Represents a framebuffer object - render targets other than the window
+ * the textures are not owned, they have to outlive the framebuffer
+ */
+class FrameBuffer
+{
+private:
+  unsigned int m_RendererID;
+  unsigned int m_ColorAttachments;
+  
+public:
+  FrameBuffer();
+  ~FrameBuffer();
+  
+  /**
+   * colour attachments go to GL_COLOR_ATTACHMENT0, 1, 2... in the order they are attached
+   * at most 8, fewer if GL_MAX_DRAW_BUFFERS is lower - one more is an ASSERT and isnt attached
+   */
+  void AttachColor(const Texture &texture);
+  void AttachDepth(const Texture &texture);
+  
+  bool IsComplete() const;
+  
+  void Bind() const;
+  void Unbind() const;
+};
+
+#endif /* FrameBuffer_hpp */
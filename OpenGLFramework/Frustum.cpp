@@ -0,0 +1,64 @@
+//
+//  Frustum.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "Frustum.hpp"
+
+/**
+ * Gribb & Hartmann plane extraction
+ * glm is column major so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+ */
+Frustum::Frustum(const glm::mat4 &viewProjection)
+{
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; i++)
+  {
+    rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+  }
+  
+  m_Planes[0] = rows[3] + rows[0];  // left
+  m_Planes[1] = rows[3] - rows[0];  // right
+  m_Planes[2] = rows[3] + rows[1];  // bottom
+  m_Planes[3] = rows[3] - rows[1];  // top
+  m_Planes[4] = rows[3] + rows[2];  // near
+  m_Planes[5] = rows[3] - rows[2];  // far
+  
+//  normalise so the distances we compute are in world units
+  for (auto &plane : m_Planes)
+  {
+    float length = glm::length(glm::vec3(plane.x, plane.y, plane.z));
+    plane = plane / length;
+  }
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const
+{
+  for (const auto &plane : m_Planes)
+  {
+    if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Frustum::IntersectsAABB(const glm::vec3 &min, const glm::vec3 &max) const
+{
+  for (const auto &plane : m_Planes)
+  {
+//    test the corner furthest along the plane normal, if that is outside the whole box is
+    float x = plane.x >= 0.0f ? max.x : min.x;
+    float y = plane.y >= 0.0f ? max.y : min.y;
+    float z = plane.z >= 0.0f ? max.z : min.z;
+    
+    if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+    {
+      return false;
+    }
+  }
+  return true;
+}
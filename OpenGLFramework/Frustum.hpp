@@ -0,0 +1,32 @@
+//
+//  Frustum.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef Frustum_hpp
+#define Frustum_hpp
+
+#include <stdio.h>
+#include "glm/glm.hpp"
+
+/**
+ * the 6 clipping planes of a view projection matrix
+ * each plane is stored as (normal, distance) with the normal pointing inside the frustum
+ */
+class Frustum
+{
+private:
+  glm::vec4 m_Planes[6];  // left, right, bottom, top, near, far
+  
+public:
+  Frustum(const glm::mat4 &viewProjection);
+  
+  bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+  bool IntersectsAABB(const glm::vec3 &min, const glm::vec3 &max) const;
+  
+  inline const glm::vec4* GetPlanes() const { return m_Planes; }
+};
+
+#endif /* Frustum_hpp */
@@ -0,0 +1,265 @@
+//
+//  GlyphAtlas.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "GlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static const float INF = 1e20f;
+
+GlyphAtlas::GlyphAtlas(int width, int height, int slotSize, int spread)
+: m_Width(width), m_Height(height), m_SlotSize(slotSize), m_Spread(spread), m_Columns(width / slotSize),
+  m_DirtyMinY(0), m_DirtyMaxY(0), m_Frame(1), m_Hits(0), m_Misses(0), m_Dropped(0)
+{
+  m_Pixels.resize(width * height, 0);
+  
+  const int slotCount = m_Columns * (height / slotSize);
+  m_Slots.resize(slotCount);
+  m_Lookup.reserve(slotCount);
+  
+//  every slot starts in the list, the free ones at the back so they get used first
+  for (int i = 0; i < slotCount; i++)
+  {
+    m_Slots[i].occupied = false;
+    m_Slots[i].lastUsedFrame = 0;
+    m_Slots[i].lru = m_LRU.insert(m_LRU.end(), i);
+  }
+  
+  const int cells = slotSize * slotSize;
+  m_Inside.resize(cells);
+  m_Outside.resize(cells);
+  m_Column.resize(slotSize);
+  m_Parabolas.resize(slotSize);
+  m_Boundaries.resize(slotSize + 1);
+  m_Result.resize(slotSize);
+}
+
+const AtlasGlyph* GlyphAtlas::GetGlyph(unsigned int codepoint, GlyphRasterizer &rasterizer)
+{
+  auto found = m_Lookup.find(codepoint);
+  if (found != m_Lookup.end())
+  {
+    Slot &slot = m_Slots[found->second];
+    slot.lastUsedFrame = m_Frame;
+    m_LRU.splice(m_LRU.begin(), m_LRU, slot.lru);
+    m_Hits++;
+    return &slot.glyph;
+  }
+  
+  auto empty = m_EmptyGlyphs.find(codepoint);
+  if (empty != m_EmptyGlyphs.end())
+  {
+    m_Hits++;
+    return &empty->second;
+  }
+  
+  m_Misses++;
+  
+//  check for room first, rasterizing a glyph that has nowhere to go is wasted work every frame the atlas is full
+  const int slotIndex = FindSlot();
+  if (slotIndex < 0)
+  {
+//    empty glyphs never need a slot, only drop the ones with something to draw
+    if (!rasterizer.GetMetrics(codepoint, m_Bitmap)) return nullptr;
+    if (m_Bitmap.width == 0 || m_Bitmap.height == 0) return AddEmptyGlyph(codepoint, m_Bitmap.advance);
+    
+    m_Dropped++;
+    return nullptr;
+  }
+  
+  if (!rasterizer.Rasterize(codepoint, m_Bitmap)) return nullptr;
+  
+//  nothing to draw, just remember the advance
+  if (m_Bitmap.width == 0 || m_Bitmap.height == 0) return AddEmptyGlyph(codepoint, m_Bitmap.advance);
+  
+  Slot &slot = m_Slots[slotIndex];
+  m_LRU.splice(m_LRU.begin(), m_LRU, slot.lru);
+  if (slot.occupied)
+  {
+    m_Lookup.erase(slot.codepoint);
+  }
+  
+  slot.codepoint = codepoint;
+  slot.occupied = true;
+  slot.lastUsedFrame = m_Frame;
+  m_Lookup[codepoint] = slotIndex;
+  
+  WriteDistanceField(slotIndex, m_Bitmap);
+  
+//  the glyph sits in the bottom left of the slot with the padding around it
+  const int slotX = (slotIndex % m_Columns) * m_SlotSize;
+  const int slotY = (slotIndex / m_Columns) * m_SlotSize;
+  const int paddedWidth = std::min(m_Bitmap.width + 2 * m_Spread, m_SlotSize);
+  const int paddedHeight = std::min(m_Bitmap.height + 2 * m_Spread, m_SlotSize);
+  
+  AtlasGlyph &glyph = slot.glyph;
+  glyph.uv = glm::vec4((float)slotX / m_Width, (float)slotY / m_Height,
+                       (float)(slotX + paddedWidth) / m_Width, (float)(slotY + paddedHeight) / m_Height);
+  glyph.width = (float)paddedWidth;
+  glyph.height = (float)paddedHeight;
+  glyph.offsetX = m_Bitmap.bearingX - m_Spread;
+  glyph.offsetY = m_Bitmap.bearingY + m_Spread - paddedHeight;
+  glyph.advance = m_Bitmap.advance;
+  
+  return &glyph;
+}
+
+/**
+ * the back of the LRU list is the least recently used slot
+ */
+int GlyphAtlas::FindSlot() const
+{
+  if (m_LRU.empty()) return -1;
+  
+  int slotIndex = m_LRU.back();
+  
+//  everything is in use this frame, reusing a slot would break text that is already laid out
+  if (m_Slots[slotIndex].occupied && m_Slots[slotIndex].lastUsedFrame == m_Frame) return -1;
+  
+  return slotIndex;
+}
+
+const AtlasGlyph* GlyphAtlas::AddEmptyGlyph(unsigned int codepoint, float advance)
+{
+  AtlasGlyph &glyph = m_EmptyGlyphs[codepoint];
+  glyph = { glm::vec4(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, advance };
+  return &glyph;
+}
+
+void GlyphAtlas::WriteDistanceField(int slotIndex, const GlyphBitmap &bitmap)
+{
+  const int size = m_SlotSize;
+  const int width = std::min(bitmap.width, size - 2 * m_Spread);
+  const int height = std::min(bitmap.height, size - 2 * m_Spread);
+  const int paddedWidth = width + 2 * m_Spread;
+  const int paddedHeight = height + 2 * m_Spread;
+  
+//  0 where the feature we measure the distance to is, infinity everywhere else
+  for (int y = 0; y < paddedHeight; y++)
+  {
+    for (int x = 0; x < paddedWidth; x++)
+    {
+      int gx = x - m_Spread, gy = y - m_Spread;
+      bool inside = gx >= 0 && gy >= 0 && gx < width && gy < height && bitmap.pixels[gy * bitmap.width + gx] >= 128;
+      
+      m_Outside[y * paddedWidth + x] = inside ? 0.0f : INF;   // distance to the nearest inside pixel
+      m_Inside[y * paddedWidth + x] = inside ? INF : 0.0f;    // distance to the nearest outside pixel
+    }
+  }
+  
+  DistanceTransform(m_Outside, paddedWidth, paddedHeight);
+  DistanceTransform(m_Inside, paddedWidth, paddedHeight);
+  
+  const int slotX = (slotIndex % m_Columns) * m_SlotSize;
+  const int slotY = (slotIndex / m_Columns) * m_SlotSize;
+  
+  for (int y = 0; y < paddedHeight; y++)
+  {
+//    bitmaps are top row first but texture rows go bottom up
+    unsigned char *row = &m_Pixels[(slotY + paddedHeight - 1 - y) * m_Width + slotX];
+    
+    for (int x = 0; x < paddedWidth; x++)
+    {
+      float outside = m_Outside[y * paddedWidth + x];
+      float inside = m_Inside[y * paddedWidth + x];
+      
+//      pixel centres are half a pixel from the edge, 128 is exactly on it and higher is inside
+      float distance = outside > 0.0f ? -(std::sqrt(outside) - 0.5f) : std::sqrt(inside) - 0.5f;
+      float value = 128.0f + distance * 127.0f / m_Spread;
+      
+      row[x] = (unsigned char)std::min(std::max(value, 0.0f), 255.0f);
+    }
+  }
+  
+  m_DirtyMinY = IsDirty() ? std::min(m_DirtyMinY, slotY) : slotY;
+  m_DirtyMaxY = std::max(m_DirtyMaxY, slotY + paddedHeight);
+}
+
+/**
+ * squared euclidean distance transform, Felzenszwalb & Huttenlocher - columns then rows
+ */
+void GlyphAtlas::DistanceTransform(std::vector<float> &grid, int width, int height)
+{
+  for (int x = 0; x < width; x++)
+  {
+    for (int y = 0; y < height; y++) m_Column[y] = grid[y * width + x];
+    DistanceTransform1D(m_Column.data(), height);
+    for (int y = 0; y < height; y++) grid[y * width + x] = m_Result[y];
+  }
+  
+  for (int y = 0; y < height; y++)
+  {
+    DistanceTransform1D(&grid[y * width], width);
+    std::copy(m_Result.begin(), m_Result.begin() + width, grid.begin() + y * width);
+  }
+}
+
+/**
+ * lower envelope of the parabolas rooted at every sample, result goes into m_Result
+ */
+void GlyphAtlas::DistanceTransform1D(const float *f, int n)
+{
+  float *v = m_Parabolas.data();
+  float *z = m_Boundaries.data();
+  
+  int k = 0;
+  v[0] = 0.0f;
+  z[0] = -INF;
+  z[1] = INF;
+  
+  for (int q = 1; q < n; q++)
+  {
+    int p = (int)v[k];
+    float s = ((f[q] + q * q) - (f[p] + p * p)) / (2.0f * q - 2.0f * p);
+    
+//    pop the parabolas the new one hides, z[0] is -infinity so this stops at the first one
+    while (s <= z[k])
+    {
+      k--;
+      p = (int)v[k];
+      s = ((f[q] + q * q) - (f[p] + p * p)) / (2.0f * q - 2.0f * p);
+    }
+    
+    k++;
+    v[k] = (float)q;
+    z[k] = s;
+    z[k + 1] = INF;
+  }
+  
+  k = 0;
+  for (int q = 0; q < n; q++)
+  {
+    while (z[k + 1] < q) k++;
+    int p = (int)v[k];
+    m_Result[q] = (q - p) * (q - p) + f[p];
+  }
+}
+
+void GlyphAtlas::NextFrame()
+{
+  m_Frame++;
+}
+
+void GlyphAtlas::ClearDirty()
+{
+  m_DirtyMinY = 0;
+  m_DirtyMaxY = 0;
+}
+
+float GlyphAtlas::GetHitRate() const
+{
+  unsigned long long total = m_Hits + m_Misses;
+  return total == 0 ? 0.0f : (float)m_Hits / total;
+}
+
+void GlyphAtlas::ResetStats()
+{
+  m_Hits = 0;
+  m_Misses = 0;
+  m_Dropped = 0;
+}
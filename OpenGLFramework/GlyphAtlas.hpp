@@ -0,0 +1,145 @@
+//
+//  GlyphAtlas.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef GlyphAtlas_hpp
+#define GlyphAtlas_hpp
+
+#include <stdio.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/**
+ * coverage of one glyph as the rasterizer hands it to us
+ * pixels are width * height bytes, top row first
+ * bearingY is the distance from the baseline up to the top row
+ */
+struct GlyphBitmap
+{
+  int width, height;
+  float bearingX, bearingY;
+  float advance;
+  std::vector<unsigned char> pixels;
+};
+
+/**
+ * anything that can turn a codepoint into a coverage bitmap
+ */
+class GlyphRasterizer
+{
+public:
+  virtual ~GlyphRasterizer() {}
+  
+  /**
+   * false if the codepoint isnt in the font
+   */
+  virtual bool Rasterize(unsigned int codepoint, GlyphBitmap &out) = 0;
+  virtual float GetLineHeight() const = 0;
+  
+  /**
+   * everything but the pixels, width and height are 0 when there is nothing to draw
+   * the atlas asks for this when it has no free slot, override it if the font can tell without rasterizing
+   */
+  virtual bool GetMetrics(unsigned int codepoint, GlyphBitmap &out) { return Rasterize(codepoint, out); }
+};
+
+/**
+ * where a glyph ended up in the atlas and how to place its quad
+ * the quad includes the distance field padding
+ */
+struct AtlasGlyph
+{
+  glm::vec4 uv;           // u0, v0, u1, v1
+  float width, height;    // quad size in font pixels
+  float offsetX, offsetY; // bottom left of the quad relative to the pen on the baseline
+  float advance;
+};
+
+/**
+ * single channel signed distance field atlas split into equal sized slots
+ *
+ * glyphs are rasterized and converted to a distance field the first time they are asked for
+ * when the atlas is full the least recently used slot is reused, slots used in the current frame are never evicted
+ * this is CPU only - whoever owns the texture uploads the dirty rows
+ */
+class GlyphAtlas
+{
+private:
+  struct Slot
+  {
+    unsigned int codepoint;
+    bool occupied;
+    unsigned int lastUsedFrame;
+    AtlasGlyph glyph;
+    std::list<int>::iterator lru;
+  };
+  
+  int m_Width, m_Height;
+  int m_SlotSize;
+  int m_Spread;             // distance in pixels the field covers either side of the edge
+  int m_Columns;
+  
+  std::vector<unsigned char> m_Pixels;
+  std::vector<Slot> m_Slots;
+  std::list<int> m_LRU;     // front is the most recently used slot
+  std::unordered_map<unsigned int, int> m_Lookup;
+  std::unordered_map<unsigned int, AtlasGlyph> m_EmptyGlyphs;   // spaces etc, they need no slot
+  
+//  scratch space so a miss doesnt allocate
+  GlyphBitmap m_Bitmap;
+  std::vector<float> m_Inside, m_Outside, m_Column, m_Parabolas, m_Boundaries, m_Result;
+  
+  int m_DirtyMinY, m_DirtyMaxY;
+  unsigned int m_Frame;
+  
+  unsigned long long m_Hits, m_Misses, m_Dropped;
+  
+public:
+  GlyphAtlas(int width, int height, int slotSize, int spread);
+  
+  /**
+   * nullptr if the rasterizer doesnt know the glyph or every slot is already in use this frame
+   * when there is no room a glyph that isnt cached yet is dropped without being rasterized,
+   * empty ones like space dont need a slot and are always returned
+   */
+  const AtlasGlyph* GetGlyph(unsigned int codepoint, GlyphRasterizer &rasterizer);
+  
+//  call once per frame after the text has been drawn
+  void NextFrame();
+  
+  inline const unsigned char* GetPixels() const { return m_Pixels.data(); }
+  inline int GetWidth() const { return m_Width; }
+  inline int GetHeight() const { return m_Height; }
+  
+  /**
+   * rows [minY, maxY) changed since the last ClearDirty
+   */
+  inline bool IsDirty() const { return m_DirtyMinY < m_DirtyMaxY; }
+  inline int GetDirtyMinY() const { return m_DirtyMinY; }
+  inline int GetDirtyMaxY() const { return m_DirtyMaxY; }
+  void ClearDirty();
+  
+  inline unsigned long long GetHits() const { return m_Hits; }
+  inline unsigned long long GetMisses() const { return m_Misses; }
+  inline unsigned long long GetDropped() const { return m_Dropped; }
+  float GetHitRate() const;
+  void ResetStats();
+  
+private:
+  /**
+   * the slot the next glyph would go into without claiming it, -1 when every slot is in use this frame
+   */
+  int FindSlot() const;
+  const AtlasGlyph* AddEmptyGlyph(unsigned int codepoint, float advance);
+  void WriteDistanceField(int slotIndex, const GlyphBitmap &bitmap);
+  void DistanceTransform(std::vector<float> &grid, int width, int height);
+  void DistanceTransform1D(const float *f, int n);
+};
+
+#endif /* GlyphAtlas_hpp */
@@ -0,0 +1,161 @@
+//
+//  IndirectRenderer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "IndirectRenderer.hpp"
+
+#include <algorithm>
+
+#include "Frustum.hpp"
+#include "VertexBufferLayout.hpp"
+
+// has to match local_size_x in Cull.shader
+static const unsigned int CULL_GROUP_SIZE = 64;
+
+// has to match objectID in Indirect.shader
+static const unsigned int OBJECT_ID_LOCATION = 2;
+
+IndirectRenderer::IndirectRenderer(VertexArray &va, const IndexBuffer &ib, unsigned int maxObjects, bool preferGPUDriven)
+: m_VertexArray(va), m_IndexBuffer(ib), m_MaxObjects(maxObjects), m_GPUDriven(preferGPUDriven && IsSupported()), m_Dirty(true)
+{
+  m_Objects.reserve(maxObjects);
+  
+  if (!m_GPUDriven) return;
+  
+  m_ObjectBuffer = std::make_unique<ShaderStorageBuffer>(nullptr, maxObjects * sizeof(ObjectData));
+  m_CommandBuffer = std::make_unique<ShaderStorageBuffer>(nullptr, maxObjects * sizeof(DrawElementsIndirectCommand));
+  
+//  Cull.shader writes object i into command i with baseInstance = i
+//  instanced attributes honour baseInstance so this gives every draw its object id
+  std::vector<unsigned int> ids(maxObjects);
+  for (unsigned int i = 0; i < maxObjects; i++) ids[i] = i;
+  
+  m_ObjectIDBuffer = std::make_unique<VertexBuffer>(ids.data(), maxObjects * sizeof(unsigned int));
+  
+  VertexBufferLayout layout;
+  layout.Push<unsigned int>(1);
+  va.AddInstanceBuffer(*m_ObjectIDBuffer, layout, OBJECT_ID_LOCATION);
+  va.Unbind();
+  
+  m_CullShader = std::make_unique<Shader>("res/shaders/Cull.shader");
+  m_DrawShader = std::make_unique<Shader>("res/shaders/Indirect.shader");
+  
+  m_DrawShader->Bind();
+  m_DrawShader->SetUniform1i("u_Texture", 0);
+  m_DrawShader->Unbind();
+}
+
+bool IndirectRenderer::IsSupported()
+{
+  int major = 0, minor = 0;
+  GLCall(glGetIntegerv(GL_MAJOR_VERSION, &major));
+  GLCall(glGetIntegerv(GL_MINOR_VERSION, &minor));
+  
+  return major > 4 || (major == 4 && minor >= 3);
+}
+
+unsigned int IndirectRenderer::AddObject(const MeshRange &mesh, const glm::mat4 &transform, const glm::vec3 &center, float radius)
+{
+  ASSERT(m_Objects.size() < m_MaxObjects);
+  
+  ObjectData object;
+  object.transform = transform;
+  object.boundingSphere = glm::vec4(center, radius);
+  object.indexCount = mesh.indexCount;
+  object.firstIndex = mesh.firstIndex;
+  object.baseVertex = mesh.baseVertex;
+  object.padding = 0;
+  
+  m_Objects.push_back(object);
+  m_Dirty = true;
+  
+  return (unsigned int)m_Objects.size() - 1;
+}
+
+void IndirectRenderer::SetTransform(unsigned int id, const glm::mat4 &transform)
+{
+  m_Objects[id].transform = transform;
+  m_Dirty = true;
+}
+
+void IndirectRenderer::Clear()
+{
+  m_Objects.clear();
+  m_Dirty = true;
+}
+
+void IndirectRenderer::Draw(Shader &shader, const glm::mat4 &viewProjection)
+{
+  if (m_Objects.empty()) return;
+  
+  if (m_GPUDriven)
+  {
+    DrawGPUDriven(viewProjection);
+  }
+  else
+  {
+    DrawFallback(shader, viewProjection);
+  }
+}
+
+void IndirectRenderer::DrawGPUDriven(const glm::mat4 &viewProjection)
+{
+  const unsigned int objectCount = (unsigned int)m_Objects.size();
+  
+  if (m_Dirty)
+  {
+    m_ObjectBuffer->SetData(m_Objects.data(), objectCount * sizeof(ObjectData));
+    m_Dirty = false;
+  }
+  
+  Frustum frustum(viewProjection);
+  
+//  cull and build the draw commands
+  m_ObjectBuffer->BindBase(0);
+  m_CommandBuffer->BindBase(1);
+  
+  m_CullShader->Bind();
+  m_CullShader->SetUniform4fv("u_FrustumPlanes", 6, &frustum.GetPlanes()[0].x);
+  m_CullShader->SetUniform1ui("u_ObjectCount", objectCount);
+  m_CullShader->Dispatch((objectCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE);
+  
+//  the draw reads the commands the compute shader just wrote
+  GLCall(glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT));
+  
+//  one draw call for the whole frame
+  m_DrawShader->Bind();
+  m_DrawShader->SetUniformMat4f("u_ViewProjection", viewProjection);
+  m_VertexArray.Bind();
+  m_IndexBuffer.Bind();
+  m_CommandBuffer->BindIndirect();
+  
+  GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, objectCount, 0));
+  
+  GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+}
+
+void IndirectRenderer::DrawFallback(Shader &shader, const glm::mat4 &viewProjection)
+{
+  Frustum frustum(viewProjection);
+  
+  shader.Bind();
+  
+  for (const auto &object : m_Objects)
+  {
+    const glm::mat4 &transform = object.transform;
+    
+//    same test as Cull.shader, the sphere is scaled by the largest axis scale
+    glm::vec4 center = transform * glm::vec4(object.boundingSphere.x, object.boundingSphere.y, object.boundingSphere.z, 1.0f);
+    float scale = std::max(std::max(glm::length(glm::vec3(transform[0].x, transform[0].y, transform[0].z)),
+                                    glm::length(glm::vec3(transform[1].x, transform[1].y, transform[1].z))),
+                                    glm::length(glm::vec3(transform[2].x, transform[2].y, transform[2].z)));
+    
+    if (!frustum.IntersectsSphere(glm::vec3(center.x, center.y, center.z), object.boundingSphere.w * scale)) continue;
+    
+    shader.SetUniformMat4f("u_MVP", viewProjection * transform);
+    m_Renderer.DrawRange(m_VertexArray, m_IndexBuffer, shader, object.indexCount, object.firstIndex, object.baseVertex);
+  }
+}
@@ -0,0 +1,119 @@
+//
+//  IndirectRenderer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef IndirectRenderer_hpp
+#define IndirectRenderer_hpp
+
+#include <stdio.h>
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Renderer.h"
+#include "VertexBuffer.hpp"
+#include "ShaderStorageBuffer.hpp"
+
+/**
+ * layout has to match DrawElementsIndirectCommand in the OpenGL spec
+ */
+struct DrawElementsIndirectCommand
+{
+  unsigned int count;
+  unsigned int instanceCount;
+  unsigned int firstIndex;
+  int baseVertex;
+  unsigned int baseInstance;
+};
+
+/**
+ * where a mesh lives inside the shared vertex and index buffers
+ */
+struct MeshRange
+{
+  unsigned int indexCount;
+  unsigned int firstIndex;
+  int baseVertex;
+};
+
+/**
+ * per object data as it is laid out in the std430 buffer of Cull.shader and Indirect.shader
+ */
+struct ObjectData
+{
+  glm::mat4 transform;
+  glm::vec4 boundingSphere;   // xyz local center, w local radius
+  unsigned int indexCount;
+  unsigned int firstIndex;
+  int baseVertex;
+  unsigned int padding;
+};
+
+/**
+ * Draws every object of a shared mesh pool
+ *
+ * On 4.3+ contexts the objects live in a shader storage buffer, Cull.shader frustum culls them
+ * and writes one draw command each, and the whole frame goes out with one glMultiDrawElementsIndirect
+ * On 3.3 contexts it falls back to culling on the CPU and a Renderer::DrawRange per visible object
+ */
+class IndirectRenderer
+{
+private:
+  const VertexArray &m_VertexArray;
+  const IndexBuffer &m_IndexBuffer;
+  unsigned int m_MaxObjects;
+  bool m_GPUDriven;
+  bool m_Dirty;               // objects changed since the last upload
+  
+  std::vector<ObjectData> m_Objects;
+  
+//  only created when the GPU driven path is used
+  std::unique_ptr<ShaderStorageBuffer> m_ObjectBuffer;
+  std::unique_ptr<ShaderStorageBuffer> m_CommandBuffer;
+  std::unique_ptr<VertexBuffer> m_ObjectIDBuffer;
+  std::unique_ptr<Shader> m_CullShader;
+  std::unique_ptr<Shader> m_DrawShader;
+  
+  Renderer m_Renderer;
+  
+public:
+  /**
+   * va has to have position at location 0 and the texture coordinate at location 1, same as Basic.shader
+   * the object id is added as an instanced attribute at location 2, replacing whatever was there
+   * so va should only be used by one GPU driven renderer at a time
+   * preferGPUDriven = false forces the fallback path, which is handy for comparing the two
+   */
+  IndirectRenderer(VertexArray &va, const IndexBuffer &ib, unsigned int maxObjects, bool preferGPUDriven = true);
+  
+  /**
+   * true when the context is 4.3 or above, which has compute shaders, SSBOs and multi draw indirect
+   */
+  static bool IsSupported();
+  
+  /**
+   * center and radius are the bounding sphere of the mesh in model space
+   * returns the id to update the object with
+   */
+  unsigned int AddObject(const MeshRange &mesh, const glm::mat4 &transform, const glm::vec3 &center, float radius);
+  void SetTransform(unsigned int id, const glm::mat4 &transform);
+  void Clear();
+  
+  /**
+   * shader is only used by the fallback path and needs a u_MVP uniform like Basic.shader
+   * the GPU driven path uses its own Indirect.shader
+   */
+  void Draw(Shader &shader, const glm::mat4 &viewProjection);
+  
+  inline bool IsGPUDriven() const { return m_GPUDriven; }
+  inline unsigned int GetObjectCount() const { return (unsigned int)m_Objects.size(); }
+  
+private:
+  void DrawGPUDriven(const glm::mat4 &viewProjection);
+  void DrawFallback(Shader &shader, const glm::mat4 &viewProjection);
+};
+
+#endif /* IndirectRenderer_hpp */
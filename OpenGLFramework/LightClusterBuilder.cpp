@@ -0,0 +1,295 @@
+//
+//  LightClusterBuilder.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "LightClusterBuilder.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+  #define CLUSTERS_SSE 1
+#endif
+
+static const unsigned int MIN_LIGHTS_PER_JOB = 1024;
+
+LightClusterBuilder::LightClusterBuilder(unsigned int tilesX, unsigned int tilesY, unsigned int slices)
+: LightClusterBuilder(tilesX, tilesY, slices, ThreadPool::Get())
+{
+}
+
+LightClusterBuilder::LightClusterBuilder(unsigned int tilesX, unsigned int tilesY, unsigned int slices, ThreadPool &threadPool)
+: m_TilesX(tilesX), m_TilesY(tilesY), m_Slices(slices), m_Near(0.1f), m_Far(100.0f), m_TanHalfFovX(1.0f), m_TanHalfFovY(1.0f),
+  m_ThreadPool(threadPool)
+{
+  const unsigned int clusterCount = tilesX * tilesY * slices;
+  m_MinX.resize(clusterCount);
+  m_MinY.resize(clusterCount);
+  m_MinZ.resize(clusterCount);
+  m_MaxX.resize(clusterCount);
+  m_MaxY.resize(clusterCount);
+  m_MaxZ.resize(clusterCount);
+  m_Clusters.resize(clusterCount);
+  
+  m_SliceIndices.resize(slices);
+  m_SliceClusterLights.resize(slices);
+  m_SliceOffsets.resize(slices + 1);
+}
+
+void LightClusterBuilder::SetProjection(float fovY, float aspect, float nearPlane, float farPlane)
+{
+  m_Near = nearPlane;
+  m_Far = farPlane;
+  m_TanHalfFovY = std::tan(fovY * 0.5f);
+  m_TanHalfFovX = m_TanHalfFovY * aspect;
+  
+//  view space boxes, depth is positive going into the screen
+  for (unsigned int z = 0; z < m_Slices; z++)
+  {
+    const float sliceNear = m_Near * std::pow(m_Far / m_Near, (float)z / m_Slices);
+    const float sliceFar = m_Near * std::pow(m_Far / m_Near, (float)(z + 1) / m_Slices);
+    
+    for (unsigned int y = 0; y < m_TilesY; y++)
+    {
+      const float y0 = (2.0f * y / m_TilesY - 1.0f) * m_TanHalfFovY;
+      const float y1 = (2.0f * (y + 1) / m_TilesY - 1.0f) * m_TanHalfFovY;
+      
+      for (unsigned int x = 0; x < m_TilesX; x++)
+      {
+        const float x0 = (2.0f * x / m_TilesX - 1.0f) * m_TanHalfFovX;
+        const float x1 = (2.0f * (x + 1) / m_TilesX - 1.0f) * m_TanHalfFovX;
+        
+        const unsigned int i = x + y * m_TilesX + z * m_TilesX * m_TilesY;
+        
+//        the tile widens with depth so the box has to cover both ends of the slice
+        m_MinX[i] = std::min(x0 * sliceNear, x0 * sliceFar);
+        m_MaxX[i] = std::max(x1 * sliceNear, x1 * sliceFar);
+        m_MinY[i] = std::min(y0 * sliceNear, y0 * sliceFar);
+        m_MaxY[i] = std::max(y1 * sliceNear, y1 * sliceFar);
+        m_MinZ[i] = sliceNear;
+        m_MaxZ[i] = sliceFar;
+      }
+    }
+  }
+}
+
+int LightClusterBuilder::GetSlice(float depth) const
+{
+  if (depth <= m_Near) return 0;
+  
+  int slice = (int)std::floor(std::log(depth / m_Near) / std::log(m_Far / m_Near) * m_Slices);
+  return std::min(slice, (int)m_Slices - 1);
+}
+
+int LightClusterBuilder::GetTile(float x, float depth, float tanHalfFov, unsigned int tiles) const
+{
+  float ndc = x / (depth * tanHalfFov);
+  return (int)std::floor((ndc + 1.0f) * 0.5f * tiles);
+}
+
+void LightClusterBuilder::Build(const std::vector<PointLight> &lights, const glm::mat4 &view)
+{
+  const unsigned int lightCount = (unsigned int)lights.size();
+  
+  m_LightX.resize(lightCount);
+  m_LightY.resize(lightCount);
+  m_LightZ.resize(lightCount);
+  m_LightRadius.resize(lightCount);
+  
+//  into view space, flipping z so depth is positive
+  m_ThreadPool.ParallelFor(lightCount, MIN_LIGHTS_PER_JOB, [&](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int i = begin; i < end; i++)
+    {
+      glm::vec4 position = view * glm::vec4(lights[i].position, 1.0f);
+      m_LightX[i] = position.x;
+      m_LightY[i] = position.y;
+      m_LightZ[i] = -position.z;
+      m_LightRadius[i] = lights[i].radius;
+    }
+  });
+  
+  BucketLights();
+  
+  m_ThreadPool.ParallelFor(m_Slices, 1, [this](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int slice = begin; slice < end; slice++) AssignSlice(slice);
+  });
+  
+//  join the slices into one index list
+  const unsigned int clustersPerSlice = m_TilesX * m_TilesY;
+  std::vector<unsigned int> &offsets = m_SliceOffsets;
+  offsets[0] = 0;
+  for (unsigned int slice = 0; slice < m_Slices; slice++)
+  {
+    offsets[slice + 1] = offsets[slice] + (unsigned int)m_SliceIndices[slice].size();
+  }
+  m_LightIndices.resize(offsets[m_Slices]);
+  
+  m_ThreadPool.ParallelFor(m_Slices, 1, [&](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int slice = begin; slice < end; slice++)
+    {
+      std::copy(m_SliceIndices[slice].begin(), m_SliceIndices[slice].end(), m_LightIndices.begin() + offsets[slice]);
+      
+      for (unsigned int i = 0; i < clustersPerSlice; i++)
+      {
+        m_Clusters[slice * clustersPerSlice + i].offset += offsets[slice];
+      }
+    }
+  });
+}
+
+/**
+ * counting sort of the lights into the slices their depth range covers
+ * m_SliceOffsets is borrowed as the counts here, Build rewrites it afterwards
+ */
+void LightClusterBuilder::BucketLights()
+{
+  const unsigned int lightCount = (unsigned int)m_LightZ.size();
+  std::vector<unsigned int> &counts = m_SliceOffsets;
+  std::fill(counts.begin(), counts.end(), 0);
+  
+  auto range = [this](unsigned int i, int &first, int &last)
+  {
+    const float depth = m_LightZ[i], radius = m_LightRadius[i];
+    if (depth + radius < m_Near || depth - radius > m_Far) return false;
+    
+    first = GetSlice(depth - radius);
+    last = GetSlice(depth + radius);
+    return true;
+  };
+  
+  int first, last;
+  for (unsigned int i = 0; i < lightCount; i++)
+  {
+    if (!range(i, first, last)) continue;
+    for (int slice = first; slice <= last; slice++) counts[slice + 1]++;
+  }
+  
+  for (unsigned int slice = 0; slice < m_Slices; slice++) counts[slice + 1] += counts[slice];
+  m_SliceLights.resize(counts[m_Slices]);
+  
+  for (unsigned int i = 0; i < lightCount; i++)
+  {
+    if (!range(i, first, last)) continue;
+    for (int slice = first; slice <= last; slice++) m_SliceLights[counts[slice]++] = i;
+  }
+  
+//  counts[slice] now points at the end of the slice, shift back so [slice] is the start again
+  for (unsigned int slice = m_Slices; slice > 0; slice--) counts[slice] = counts[slice - 1];
+  counts[0] = 0;
+}
+
+void LightClusterBuilder::AssignSlice(unsigned int slice)
+{
+  const unsigned int clustersPerSlice = m_TilesX * m_TilesY;
+  const unsigned int sliceBase = slice * clustersPerSlice;
+  
+//  (cluster in slice, light) pairs for this slice
+  std::vector<unsigned int> &pairs = m_SliceClusterLights[slice];
+  pairs.clear();
+  
+  const float sliceNear = m_MinZ[sliceBase];
+  const float sliceFar = m_MaxZ[sliceBase];
+  
+  for (unsigned int n = m_SliceOffsets[slice]; n < m_SliceOffsets[slice + 1]; n++)
+  {
+    const unsigned int light = m_SliceLights[n];
+    const float lx = m_LightX[light], ly = m_LightY[light], lz = m_LightZ[light], radius = m_LightRadius[light];
+    
+//    the part of the sphere inside this slice, its edges give the tile range
+    const float nearDepth = std::max(sliceNear, lz - radius);
+    const float farDepth = std::min(sliceFar, lz + radius);
+    
+    int x0 = std::min(GetTile(lx - radius, nearDepth, m_TanHalfFovX, m_TilesX), GetTile(lx - radius, farDepth, m_TanHalfFovX, m_TilesX));
+    int x1 = std::max(GetTile(lx + radius, nearDepth, m_TanHalfFovX, m_TilesX), GetTile(lx + radius, farDepth, m_TanHalfFovX, m_TilesX));
+    int y0 = std::min(GetTile(ly - radius, nearDepth, m_TanHalfFovY, m_TilesY), GetTile(ly - radius, farDepth, m_TanHalfFovY, m_TilesY));
+    int y1 = std::max(GetTile(ly + radius, nearDepth, m_TanHalfFovY, m_TilesY), GetTile(ly + radius, farDepth, m_TanHalfFovY, m_TilesY));
+    
+    if (x1 < 0 || y1 < 0 || x0 >= (int)m_TilesX || y0 >= (int)m_TilesY) continue;
+    
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, (int)m_TilesX - 1);
+    y1 = std::min(y1, (int)m_TilesY - 1);
+    
+    const float radiusSquared = radius * radius;
+    
+    for (int y = y0; y <= y1; y++)
+    {
+      const unsigned int row = sliceBase + y * m_TilesX;
+      int x = x0;
+      
+#if CLUSTERS_SSE
+//      sphere against 4 boxes at once - squared distance from the centre to each box
+      const __m128 cx = _mm_set1_ps(lx), cy = _mm_set1_ps(ly), cz = _mm_set1_ps(lz);
+      const __m128 r2 = _mm_set1_ps(radiusSquared);
+      const __m128 zero = _mm_setzero_ps();
+      
+      for (; x + 4 <= x1 + 1; x += 4)
+      {
+        const unsigned int i = row + x;
+        
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinX[i]), cx), _mm_sub_ps(cx, _mm_loadu_ps(&m_MaxX[i]))), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinY[i]), cy), _mm_sub_ps(cy, _mm_loadu_ps(&m_MaxY[i]))), zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_MinZ[i]), cz), _mm_sub_ps(cz, _mm_loadu_ps(&m_MaxZ[i]))), zero);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distance, r2));
+        for (int lane = 0; lane < 4; lane++)
+        {
+          if (mask & (1 << lane))
+          {
+            pairs.push_back(i + lane - sliceBase);
+            pairs.push_back(light);
+          }
+        }
+      }
+#endif
+      
+      for (; x <= x1; x++)
+      {
+        const unsigned int i = row + x;
+        
+        float dx = std::max(std::max(m_MinX[i] - lx, lx - m_MaxX[i]), 0.0f);
+        float dy = std::max(std::max(m_MinY[i] - ly, ly - m_MaxY[i]), 0.0f);
+        float dz = std::max(std::max(m_MinZ[i] - lz, lz - m_MaxZ[i]), 0.0f);
+        
+        if (dx * dx + dy * dy + dz * dz <= radiusSquared)
+        {
+          pairs.push_back(i - sliceBase);
+          pairs.push_back(light);
+        }
+      }
+    }
+  }
+  
+//  counting sort the pairs by cluster, offsets are relative to the slice until Build joins them
+  LightCluster *clusters = &m_Clusters[sliceBase];
+  for (unsigned int i = 0; i < clustersPerSlice; i++) clusters[i] = { 0, 0 };
+  
+  for (unsigned int p = 0; p < pairs.size(); p += 2) clusters[pairs[p]].count++;
+  
+  unsigned int offset = 0;
+  for (unsigned int i = 0; i < clustersPerSlice; i++)
+  {
+    clusters[i].offset = offset;
+    offset += clusters[i].count;
+    clusters[i].count = 0;
+  }
+  
+  std::vector<unsigned int> &indices = m_SliceIndices[slice];
+  indices.resize(offset);
+  
+  for (unsigned int p = 0; p < pairs.size(); p += 2)
+  {
+    LightCluster &cluster = clusters[pairs[p]];
+    indices[cluster.offset + cluster.count++] = pairs[p + 1];
+  }
+}
@@ -0,0 +1,108 @@
+//
+//  LightClusterBuilder.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef LightClusterBuilder_hpp
+#define LightClusterBuilder_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+class ThreadPool;
+
+struct PointLight
+{
+  glm::vec3 position;   // world space
+  float radius;         // no light past this distance
+  glm::vec3 color;
+  float intensity;
+};
+
+/**
+ * per cluster entry of the grid, lights [offset, offset + count) of the index list
+ */
+struct LightCluster
+{
+  unsigned int offset;
+  unsigned int count;
+};
+
+/**
+ * CPU side of clustered forward shading - doesnt touch OpenGL
+ *
+ * the view frustum is cut into X * Y screen tiles and Z depth slices, the slices get exponentially deeper
+ * so clusters stay roughly cube shaped, every light is added to every cluster its sphere touches
+ *
+ * slices are handed to the thread pool so no two threads ever write the same cluster
+ * and the sphere against cluster box tests run 4 clusters at a time with SSE
+ */
+class LightClusterBuilder
+{
+private:
+  unsigned int m_TilesX, m_TilesY, m_Slices;
+  float m_Near, m_Far;
+  float m_TanHalfFovX, m_TanHalfFovY;
+  
+//  cluster boxes in view space as a structure of arrays, index = x + y * tilesX + z * tilesX * tilesY
+  std::vector<float> m_MinX, m_MinY, m_MinZ, m_MaxX, m_MaxY, m_MaxZ;
+  
+//  lights moved to view space, one array per component
+  std::vector<float> m_LightX, m_LightY, m_LightZ, m_LightRadius;
+  
+//  lights bucketed by the slices they touch
+  std::vector<unsigned int> m_SliceOffsets;
+  std::vector<unsigned int> m_SliceLights;
+  
+//  per slice results before they are joined
+  std::vector<std::vector<unsigned int>> m_SliceIndices;
+  std::vector<std::vector<unsigned int>> m_SliceClusterLights;
+  
+  std::vector<LightCluster> m_Clusters;
+  std::vector<unsigned int> m_LightIndices;
+  
+  ThreadPool &m_ThreadPool;
+  
+public:
+  LightClusterBuilder(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24);
+  LightClusterBuilder(unsigned int tilesX, unsigned int tilesY, unsigned int slices, ThreadPool &threadPool);
+  
+  /**
+   * has to be called before Build and again whenever the projection changes
+   */
+  void SetProjection(float fovY, float aspect, float nearPlane, float farPlane);
+  
+  void Build(const std::vector<PointLight> &lights, const glm::mat4 &view);
+  
+  inline const std::vector<LightCluster>& GetClusters() const { return m_Clusters; }
+  inline const std::vector<unsigned int>& GetLightIndices() const { return m_LightIndices; }
+  
+  /**
+   * light positions in view space from the last Build, z is flipped so depth is positive
+   */
+  inline const std::vector<float>& GetViewLightX() const { return m_LightX; }
+  inline const std::vector<float>& GetViewLightY() const { return m_LightY; }
+  inline const std::vector<float>& GetViewLightZ() const { return m_LightZ; }
+  
+  inline unsigned int GetTilesX() const { return m_TilesX; }
+  inline unsigned int GetTilesY() const { return m_TilesY; }
+  inline unsigned int GetSlices() const { return m_Slices; }
+  inline float GetNear() const { return m_Near; }
+  inline float GetFar() const { return m_Far; }
+  
+  /**
+   * the slice a view space depth (positive, in front of the camera) falls in, same maths as Lit.shader
+   */
+  int GetSlice(float depth) const;
+  
+private:
+  void BucketLights();
+  void AssignSlice(unsigned int slice);
+  int GetTile(float x, float depth, float tanHalfFov, unsigned int tiles) const;
+};
+
+#endif /* LightClusterBuilder_hpp */
@@ -0,0 +1,45 @@
+//
+//  Mesh.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "Mesh.hpp"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "VertexBufferLayout.hpp"
+
+Mesh::Mesh(const std::vector<float> &vertices, const VertexBufferLayout &layout, const std::vector<unsigned int> &indices,
+           unsigned int maxLevels, float reduction)
+: m_LODs(vertices.data(), (unsigned int)(vertices.size() * sizeof(float) / layout.GetStride()), layout.GetStride() / sizeof(float),
+         indices, maxLevels, reduction),
+  m_VertexBuffer(vertices.data(), (unsigned int)(vertices.size() * sizeof(float))),
+  m_IndexBuffer(m_LODs.GetIndices().data(), (unsigned int)m_LODs.GetIndices().size())
+{
+  m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+}
+
+unsigned int Mesh::SelectLevel(const glm::mat4 &modelView, const glm::mat4 &projection, float screenHeight, unsigned int current,
+                               float pixelError) const
+{
+  const glm::vec4 center = modelView * glm::vec4(m_LODs.GetCenter(), 1.0f);
+  
+//  the error is in object space so the model scale goes into the pixels per unit
+  const float scale = std::max(glm::length(glm::vec3(modelView[0])), std::max(glm::length(glm::vec3(modelView[1])), glm::length(glm::vec3(modelView[2]))));
+  
+  const float screenRadius = MeshLODChain::ProjectedRadius(glm::vec3(center), m_LODs.GetRadius() * scale, projection[1][1], screenHeight);
+  
+  return m_LODs.SelectLevel(screenRadius, current, pixelError);
+}
+
+void Mesh::Draw(const Renderer &renderer, const Shader &shader, unsigned int level, LODStatistics *stats) const
+{
+  const MeshLODLevel &lod = m_LODs.GetLevels()[std::min(level, m_LODs.GetLevelCount() - 1)];
+  
+  renderer.DrawRange(m_VertexArray, m_IndexBuffer, shader, lod.indexCount, lod.firstIndex);
+  
+  if (stats) stats->Record(m_LODs, std::min(level, m_LODs.GetLevelCount() - 1));
+}
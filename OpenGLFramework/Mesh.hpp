@@ -0,0 +1,56 @@
+//
+//  Mesh.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef Mesh_hpp
+#define Mesh_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "MeshLOD.hpp"
+#include "VertexArray.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+
+class VertexBufferLayout;
+class Renderer;
+class Shader;
+
+/**
+ * indexed triangle mesh with its LOD chain built on import
+ * every level shares the vertex buffer, their indices are concatenated in the one IndexBuffer
+ * the layout has to be all floats with the position in the first 3
+ */
+class Mesh
+{
+private:
+  MeshLODChain m_LODs;
+  
+  VertexBuffer m_VertexBuffer;
+  IndexBuffer m_IndexBuffer;
+  VertexArray m_VertexArray;
+  
+public:
+  Mesh(const std::vector<float> &vertices, const VertexBufferLayout &layout, const std::vector<unsigned int> &indices,
+       unsigned int maxLevels = 4, float reduction = 0.5f);
+  
+  /**
+   * level to draw this frame from the projected size of the bounds
+   * keep the returned level per object and pass it back in as current next frame for the hysteresis
+   */
+  unsigned int SelectLevel(const glm::mat4 &modelView, const glm::mat4 &projection, float screenHeight, unsigned int current,
+                           float pixelError = 1.0f) const;
+  
+  void Draw(const Renderer &renderer, const Shader &shader, unsigned int level = 0, LODStatistics *stats = nullptr) const;
+  
+  inline const MeshLODChain& GetLODs() const { return m_LODs; }
+  inline const VertexArray& GetVertexArray() const { return m_VertexArray; }
+};
+
+#endif /* Mesh_hpp */
@@ -0,0 +1,397 @@
+//
+//  MeshLOD.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "MeshLOD.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/**
+ * symmetric 4x4 error quadric, only the upper triangle is stored
+ * weight is the total area that went into it so the error can be turned back into a distance
+ */
+struct Quadric
+{
+  double a00, a01, a02, a03;
+  double a11, a12, a13;
+  double a22, a23;
+  double a33;
+  double weight;
+};
+
+void AddPlane(Quadric &q, double a, double b, double c, double d, double w)
+{
+  q.a00 += w * a * a; q.a01 += w * a * b; q.a02 += w * a * c; q.a03 += w * a * d;
+  q.a11 += w * b * b; q.a12 += w * b * c; q.a13 += w * b * d;
+  q.a22 += w * c * c; q.a23 += w * c * d;
+  q.a33 += w * d * d;
+  q.weight += w;
+}
+
+void AddQuadric(Quadric &q, const Quadric &r)
+{
+  q.a00 += r.a00; q.a01 += r.a01; q.a02 += r.a02; q.a03 += r.a03;
+  q.a11 += r.a11; q.a12 += r.a12; q.a13 += r.a13;
+  q.a22 += r.a22; q.a23 += r.a23;
+  q.a33 += r.a33;
+  q.weight += r.weight;
+}
+
+/**
+ * mean squared distance from p to the planes in q and p's
+ */
+double Evaluate(const Quadric &q, const Quadric &r, const float *p)
+{
+  const double x = p[0], y = p[1], z = p[2];
+
+  const double error =
+    (q.a00 + r.a00) * x * x + 2.0 * (q.a01 + r.a01) * x * y + 2.0 * (q.a02 + r.a02) * x * z + 2.0 * (q.a03 + r.a03) * x +
+    (q.a11 + r.a11) * y * y + 2.0 * (q.a12 + r.a12) * y * z + 2.0 * (q.a13 + r.a13) * y +
+    (q.a22 + r.a22) * z * z + 2.0 * (q.a23 + r.a23) * z +
+    (q.a33 + r.a33);
+
+  const double weight = q.weight + r.weight;
+  return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+}
+
+glm::vec3 Position(const float *vertices, unsigned int stride, unsigned int v)
+{
+  const float *p = vertices + (size_t)v * stride;
+  return glm::vec3(p[0], p[1], p[2]);
+}
+
+struct Edge
+{
+  unsigned int a, b;        // a < b
+  unsigned int triangle;
+};
+
+struct Collapse
+{
+  unsigned int from, to;
+  double error;
+};
+
+// keeps the outline in place - edges on the border get a plane perpendicular to their face
+const double BOUNDARY_WEIGHT = 10.0;
+
+}
+
+MeshLODChain::MeshLODChain(const float *vertices, unsigned int vertexCount, unsigned int stride, const std::vector<unsigned int> &indices,
+                           unsigned int maxLevels, float reduction)
+: m_Center(0.0f), m_Radius(0.0f)
+{
+  if (vertexCount > 0)
+  {
+    glm::vec3 min = Position(vertices, stride, 0);
+    glm::vec3 max = min;
+    for (unsigned int v = 1; v < vertexCount; v++)
+    {
+      min = glm::min(min, Position(vertices, stride, v));
+      max = glm::max(max, Position(vertices, stride, v));
+    }
+
+    m_Center = (min + max) * 0.5f;
+    for (unsigned int v = 0; v < vertexCount; v++)
+    {
+      m_Radius = std::max(m_Radius, glm::length(Position(vertices, stride, v) - m_Center));
+    }
+  }
+
+  m_Indices = indices;
+  m_Levels.push_back({ 0, (unsigned int)indices.size(), 0.0f });
+
+//  unary + makes a copy, std::min takes references and MaxLevels has no out of line definition
+  maxLevels = std::min(maxLevels, +MaxLevels);
+
+  std::vector<unsigned int> current = indices;
+  float error = 0.0f;
+
+  while (m_Levels.size() < maxLevels)
+  {
+    const unsigned int target = (unsigned int)(current.size() / 3 * reduction) * 3;
+    if (target < 3) break;
+
+    float levelError = 0.0f;
+    std::vector<unsigned int> next = Simplify(vertices, vertexCount, stride, current, target, &levelError);
+
+//    not worth another level if it barely shrank
+    if (next.empty() || next.size() > current.size() * 9 / 10) break;
+
+//    each level is simplified from the one before it so the errors stack up
+    error += levelError;
+
+    m_Levels.push_back({ (unsigned int)m_Indices.size(), (unsigned int)next.size(), error });
+    m_Indices.insert(m_Indices.end(), next.begin(), next.end());
+
+    current.swap(next);
+  }
+}
+
+unsigned int MeshLODChain::SelectLevel(float screenRadius, unsigned int current, float pixelError, float hysteresis) const
+{
+  const unsigned int count = (unsigned int)m_Levels.size();
+  if (count == 1 || m_Radius <= 0.0f) return 0;
+
+  const float pixelsPerUnit = screenRadius / m_Radius;
+
+  unsigned int target = 0;
+  for (unsigned int i = count - 1; i > 0; i--)
+  {
+    if (m_Levels[i].error * pixelsPerUnit <= pixelError)
+    {
+      target = i;
+      break;
+    }
+  }
+
+//  going coarser happens straight away, going finer waits until the current level is clearly off
+  current = std::min(current, count - 1);
+  if (target < current && m_Levels[current].error * pixelsPerUnit <= pixelError * (1.0f + hysteresis))
+  {
+    return current;
+  }
+
+  return target;
+}
+
+float MeshLODChain::ProjectedRadius(const glm::vec3 &viewCenter, float radius, float projectionScale, float screenHeight)
+{
+  const float distance = glm::length(viewCenter);
+
+//  camera inside the bounds - as big as it gets
+  if (distance <= radius) return screenHeight;
+
+  return radius * projectionScale / distance * 0.5f * screenHeight;
+}
+
+std::vector<unsigned int> MeshLODChain::Simplify(const float *vertices, unsigned int vertexCount, unsigned int stride,
+                                                 const std::vector<unsigned int> &indices, unsigned int targetIndexCount, float *outError)
+{
+  std::vector<unsigned int> result = indices;
+  double maxError = 0.0;
+
+  const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+
+//  vertices that share a position with another vertex sit on a uv or normal seam
+//  collapsing one side of a seam would tear it open so they stay where they are
+  std::vector<char> locked(vertexCount, 0);
+  {
+    std::vector<unsigned int> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b)
+    {
+      const float *pa = vertices + (size_t)a * stride;
+      const float *pb = vertices + (size_t)b * stride;
+      return std::lexicographical_compare(pa, pa + 3, pb, pb + 3);
+    });
+
+    for (unsigned int i = 1; i < vertexCount; i++)
+    {
+      const float *pa = vertices + (size_t)order[i - 1] * stride;
+      const float *pb = vertices + (size_t)order[i] * stride;
+      if (pa[0] == pb[0] && pa[1] == pb[1] && pa[2] == pb[2])
+      {
+        locked[order[i - 1]] = 1;
+        locked[order[i]] = 1;
+      }
+    }
+  }
+
+//  area weighted plane of every triangle goes into its 3 vertices
+  std::vector<Quadric> quadrics(vertexCount, Quadric());
+  std::vector<glm::vec3> normals(triangleCount);
+
+  for (unsigned int t = 0; t < triangleCount; t++)
+  {
+    const glm::vec3 p0 = Position(vertices, stride, indices[t * 3 + 0]);
+    const glm::vec3 p1 = Position(vertices, stride, indices[t * 3 + 1]);
+    const glm::vec3 p2 = Position(vertices, stride, indices[t * 3 + 2]);
+
+    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    const float area = glm::length(normal);
+    if (area == 0.0f) continue;
+
+    normal = normal / area;
+    normals[t] = normal;
+
+    const float d = -glm::dot(normal, p0);
+    for (unsigned int k = 0; k < 3; k++)
+    {
+      AddPlane(quadrics[indices[t * 3 + k]], normal.x, normal.y, normal.z, d, area * 0.5);
+    }
+  }
+
+//  edges used by only one triangle are on the border
+  {
+    std::vector<Edge> edges;
+    edges.reserve(indices.size());
+    for (unsigned int t = 0; t < triangleCount; t++)
+    {
+      for (unsigned int k = 0; k < 3; k++)
+      {
+        const unsigned int a = indices[t * 3 + k];
+        const unsigned int b = indices[t * 3 + (k + 1) % 3];
+        edges.push_back({ std::min(a, b), std::max(a, b), t });
+      }
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge &l, const Edge &r) { return l.a != r.a ? l.a < r.a : l.b < r.b; });
+
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+      const bool sameAsPrevious = i > 0 && edges[i - 1].a == edges[i].a && edges[i - 1].b == edges[i].b;
+      const bool sameAsNext = i + 1 < edges.size() && edges[i + 1].a == edges[i].a && edges[i + 1].b == edges[i].b;
+      if (sameAsPrevious || sameAsNext) continue;
+
+      const glm::vec3 pa = Position(vertices, stride, edges[i].a);
+      const glm::vec3 pb = Position(vertices, stride, edges[i].b);
+      const glm::vec3 edge = pb - pa;
+      const float length = glm::length(edge);
+      if (length == 0.0f) continue;
+
+      const glm::vec3 normal = glm::normalize(glm::cross(edge, normals[edges[i].triangle]));
+      const float d = -glm::dot(normal, pa);
+      const double weight = BOUNDARY_WEIGHT * length * length;
+
+      AddPlane(quadrics[edges[i].a], normal.x, normal.y, normal.z, d, weight);
+      AddPlane(quadrics[edges[i].b], normal.x, normal.y, normal.z, d, weight);
+    }
+  }
+
+  std::vector<unsigned int> remap(vertexCount);
+  std::vector<char> touched(vertexCount);
+  std::vector<unsigned int> adjacencyOffsets(vertexCount + 1);
+  std::vector<unsigned int> adjacency;
+  std::vector<Collapse> collapses;
+
+//  every pass collapses the cheapest edges that dont overlap, then cleans up the index list
+  while (result.size() > targetIndexCount)
+  {
+    const unsigned int currentTriangles = (unsigned int)result.size() / 3;
+
+//    triangles around each vertex
+    std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+    for (unsigned int index : result) adjacencyOffsets[index + 1]++;
+    for (unsigned int v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+    adjacency.resize(result.size());
+    {
+      std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+      for (unsigned int i = 0; i < result.size(); i++) adjacency[fill[result[i]]++] = i / 3;
+    }
+
+//    each edge once, collapsed in whichever direction is cheaper
+    collapses.clear();
+    for (unsigned int t = 0; t < currentTriangles; t++)
+    {
+      for (unsigned int k = 0; k < 3; k++)
+      {
+        const unsigned int a = result[t * 3 + k];
+        const unsigned int b = result[t * 3 + (k + 1) % 3];
+
+//        the edge shows up again in the neighbour with the other winding, keep only one of them
+//        unless its a border edge, which only shows up once
+        if (a > b)
+        {
+          bool hasTwin = false;
+          for (unsigned int j = adjacencyOffsets[b]; j < adjacencyOffsets[b + 1] && !hasTwin; j++)
+          {
+            const unsigned int *tri = &result[adjacency[j] * 3];
+            hasTwin = (tri[0] == a || tri[1] == a || tri[2] == a) && adjacency[j] != t;
+          }
+          if (hasTwin) continue;
+        }
+
+        const double ab = locked[a] ? std::numeric_limits<double>::max() : Evaluate(quadrics[a], quadrics[b], vertices + (size_t)b * stride);
+        const double ba = locked[b] ? std::numeric_limits<double>::max() : Evaluate(quadrics[a], quadrics[b], vertices + (size_t)a * stride);
+
+        if (locked[a] && locked[b]) continue;
+
+        if (ab <= ba) collapses.push_back({ a, b, ab });
+        else collapses.push_back({ b, a, ba });
+      }
+    }
+
+    std::sort(collapses.begin(), collapses.end(), [](const Collapse &l, const Collapse &r) { return l.error < r.error; });
+
+    std::iota(remap.begin(), remap.end(), 0);
+    std::fill(touched.begin(), touched.end(), 0);
+
+    const unsigned int trianglesToRemove = currentTriangles - targetIndexCount / 3;
+    unsigned int removed = 0;
+    unsigned int applied = 0;
+
+    for (const Collapse &collapse : collapses)
+    {
+      if (removed >= trianglesToRemove) break;
+      if (touched[collapse.from] || touched[collapse.to]) continue;
+
+//      make sure none of the triangles that stay would flip over
+      const glm::vec3 target = Position(vertices, stride, collapse.to);
+      unsigned int degenerate = 0;
+      bool flips = false;
+
+      for (unsigned int j = adjacencyOffsets[collapse.from]; j < adjacencyOffsets[collapse.from + 1] && !flips; j++)
+      {
+        const unsigned int *tri = &result[adjacency[j] * 3];
+        const unsigned int v0 = remap[tri[0]], v1 = remap[tri[1]], v2 = remap[tri[2]];
+
+        if (v0 == collapse.to || v1 == collapse.to || v2 == collapse.to)
+        {
+          degenerate++;
+          continue;
+        }
+
+        glm::vec3 p0 = Position(vertices, stride, v0);
+        glm::vec3 p1 = Position(vertices, stride, v1);
+        glm::vec3 p2 = Position(vertices, stride, v2);
+        const glm::vec3 before = glm::cross(p1 - p0, p2 - p0);
+
+        if (v0 == collapse.from) p0 = target;
+        if (v1 == collapse.from) p1 = target;
+        if (v2 == collapse.from) p2 = target;
+        const glm::vec3 after = glm::cross(p1 - p0, p2 - p0);
+
+        flips = glm::dot(before, after) <= 0.0f;
+      }
+      if (flips) continue;
+
+      remap[collapse.from] = collapse.to;
+      touched[collapse.from] = 1;
+      touched[collapse.to] = 1;
+      AddQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+
+      maxError = std::max(maxError, collapse.error);
+      removed += degenerate;
+      applied++;
+    }
+
+    if (applied == 0) break;
+
+//    drop the triangles that lost an edge
+    unsigned int write = 0;
+    for (unsigned int t = 0; t < currentTriangles; t++)
+    {
+      const unsigned int v0 = remap[result[t * 3 + 0]];
+      const unsigned int v1 = remap[result[t * 3 + 1]];
+      const unsigned int v2 = remap[result[t * 3 + 2]];
+      if (v0 == v1 || v1 == v2 || v0 == v2) continue;
+
+      result[write++] = v0;
+      result[write++] = v1;
+      result[write++] = v2;
+    }
+    result.resize(write);
+  }
+
+  if (outError) *outError = (float)std::sqrt(maxError);
+  return result;
+}
@@ -0,0 +1,105 @@
+//
+//  MeshLOD.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef MeshLOD_hpp
+#define MeshLOD_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/**
+ * one level of detail - a range of the shared index list
+ * error is the simplification error in object space units, 0 for the original
+ */
+struct MeshLODLevel
+{
+  unsigned int firstIndex;
+  unsigned int indexCount;
+  float error;
+};
+
+/**
+ * a chain of simplified index lists over the same vertices, LOD 0 is the original
+ * the levels are concatenated so they can live in one IndexBuffer and be drawn with Renderer::DrawRange
+ *
+ * vertices are interleaved floats with the position in the first 3, stride is in floats
+ */
+class MeshLODChain
+{
+public:
+  static const unsigned int MaxLevels = 8;
+
+private:
+  std::vector<unsigned int> m_Indices;
+  std::vector<MeshLODLevel> m_Levels;
+
+  glm::vec3 m_Center;
+  float m_Radius;
+
+public:
+  /**
+   * each level keeps about reduction of the triangles of the one before it
+   * stops early once a level cant get any smaller
+   */
+  MeshLODChain(const float *vertices, unsigned int vertexCount, unsigned int stride, const std::vector<unsigned int> &indices,
+               unsigned int maxLevels = 4, float reduction = 0.5f);
+
+  /**
+   * picks the coarsest level whose error covers at most pixelError pixels
+   * current is the level drawn last frame, a finer level is only picked once the error goes past pixelError * (1 + hysteresis)
+   * so objects sitting right on a threshold dont flip every frame
+   */
+  unsigned int SelectLevel(float screenRadius, unsigned int current, float pixelError = 1.0f, float hysteresis = 0.5f) const;
+
+  /**
+   * radius in pixels of a bounding sphere - projectionScale is projection[1][1]
+   */
+  static float ProjectedRadius(const glm::vec3 &viewCenter, float radius, float projectionScale, float screenHeight);
+
+  /**
+   * quadric error edge collapse (Garland & Heckbert) onto existing vertices so every level can share the vertex buffer
+   * vertices with the same position but different attributes (uv seams) are left alone
+   * returns the new index list, outError gets the largest collapse error
+   */
+  static std::vector<unsigned int> Simplify(const float *vertices, unsigned int vertexCount, unsigned int stride,
+                                            const std::vector<unsigned int> &indices, unsigned int targetIndexCount, float *outError = nullptr);
+
+  inline const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+  inline const std::vector<MeshLODLevel>& GetLevels() const { return m_Levels; }
+  inline unsigned int GetLevelCount() const { return (unsigned int)m_Levels.size(); }
+
+  inline const glm::vec3& GetCenter() const { return m_Center; }
+  inline float GetRadius() const { return m_Radius; }
+};
+
+
+/**
+ * triangle counts for one frame, Reset it at the start of the frame
+ */
+struct LODStatistics
+{
+  unsigned int drawCalls = 0;
+  unsigned long long triangles = 0;       // what was actually drawn
+  unsigned long long fullTriangles = 0;   // what it would have been with LOD 0 everywhere
+  unsigned int levelDraws[MeshLODChain::MaxLevels] = {};
+
+  void Reset() { *this = LODStatistics(); }
+
+  void Record(const MeshLODChain &chain, unsigned int level)
+  {
+    drawCalls++;
+    triangles += chain.GetLevels()[level].indexCount / 3;
+    fullTriangles += chain.GetLevels()[0].indexCount / 3;
+    levelDraws[level]++;
+  }
+
+  float GetReduction() const { return fullTriangles ? 1.0f - (float)triangles / (float)fullTriangles : 0.0f; }
+};
+
+#endif /* MeshLOD_hpp */
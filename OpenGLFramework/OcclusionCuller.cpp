@@ -0,0 +1,390 @@
+//
+//  OcclusionCuller.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "OcclusionCuller.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+  #define OCCLUSION_SSE 1
+#endif
+
+static const unsigned int BAND_ROWS = 8;
+
+static double MillisecondsSince(const std::chrono::high_resolution_clock::time_point &start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height)
+: OcclusionCuller(width, height, ThreadPool::Get())
+{
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height, ThreadPool &threadPool)
+: m_Width((width + 3) & ~3u), m_Height(height), m_ViewProjection(1.0f), m_ThreadPool(threadPool)
+{
+  m_Depth.resize(m_Width * m_Height, 1.0f);
+
+//  level 0 is kept in m_Depth, the vectors for it stay empty
+  unsigned int levelWidth = m_Width, levelHeight = m_Height;
+  m_LevelWidths.push_back(levelWidth);
+  m_LevelHeights.push_back(levelHeight);
+  m_MinDepth.emplace_back();
+  m_MaxDepth.emplace_back();
+
+  while (levelWidth > 1 || levelHeight > 1)
+  {
+    levelWidth = (levelWidth + 1) / 2;
+    levelHeight = (levelHeight + 1) / 2;
+
+    m_LevelWidths.push_back(levelWidth);
+    m_LevelHeights.push_back(levelHeight);
+    m_MinDepth.emplace_back(levelWidth * levelHeight, 1.0f);
+    m_MaxDepth.emplace_back(levelWidth * levelHeight, 1.0f);
+  }
+}
+
+void OcclusionCuller::BeginFrame(const glm::mat4 &viewProjection)
+{
+  m_ViewProjection = viewProjection;
+  m_Triangles.clear();
+  m_Statistics = OcclusionStatistics();
+
+  std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+}
+
+void OcclusionCuller::AddOccluder(const float *vertices, unsigned int vertexCount, unsigned int stride,
+                                  const unsigned int *indices, unsigned int indexCount, const glm::mat4 &model)
+{
+  const glm::mat4 mvp = m_ViewProjection * model;
+
+  m_ClipVertices.resize(vertexCount);
+  for (unsigned int v = 0; v < vertexCount; v++)
+  {
+    const float *p = vertices + (size_t)v * stride;
+    m_ClipVertices[v] = mvp * glm::vec4(p[0], p[1], p[2], 1.0f);
+  }
+
+  for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+  {
+    const glm::vec4 clip[3] = { m_ClipVertices[indices[i]], m_ClipVertices[indices[i + 1]], m_ClipVertices[indices[i + 2]] };
+    ClipAndSetup(clip);
+  }
+}
+
+void OcclusionCuller::ClipAndSetup(const glm::vec4 *clip)
+{
+//  only the near plane needs clipping, the rest is taken care of by the bounding box clamp
+//  anything past the far plane is deeper than the cleared buffer and never wins
+  float distance[3];
+  int inside = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    distance[i] = clip[i].z + clip[i].w;
+    if (distance[i] >= 0.0f) inside++;
+  }
+  if (inside == 0) return;
+
+  glm::vec4 polygon[4];
+  int count = 0;
+
+  if (inside == 3)
+  {
+    polygon[0] = clip[0];
+    polygon[1] = clip[1];
+    polygon[2] = clip[2];
+    count = 3;
+  }
+  else
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      const int j = (i + 1) % 3;
+      if (distance[i] >= 0.0f) polygon[count++] = clip[i];
+      if ((distance[i] >= 0.0f) != (distance[j] >= 0.0f))
+      {
+        const float t = distance[i] / (distance[i] - distance[j]);
+        polygon[count++] = clip[i] + (clip[j] - clip[i]) * t;
+      }
+    }
+  }
+
+  glm::vec3 screen[4];
+  for (int i = 0; i < count; i++)
+  {
+    const float invW = 1.0f / polygon[i].w;
+    screen[i] = glm::vec3((polygon[i].x * invW * 0.5f + 0.5f) * m_Width,
+                          (polygon[i].y * invW * 0.5f + 0.5f) * m_Height,
+                          polygon[i].z * invW * 0.5f + 0.5f);
+  }
+
+  for (int i = 1; i + 1 < count; i++)
+  {
+    SetupTriangle(screen[0], screen[i], screen[i + 1]);
+  }
+}
+
+void OcclusionCuller::SetupTriangle(const glm::vec3 &v0, const glm::vec3 &a, const glm::vec3 &b)
+{
+  float area = (a.x - v0.x) * (b.y - v0.y) - (b.x - v0.x) * (a.y - v0.y);
+  if (area == 0.0f) return;
+
+//  both sides are drawn, back facing ones just get their winding flipped
+  const glm::vec3 &v1 = area > 0.0f ? a : b;
+  const glm::vec3 &v2 = area > 0.0f ? b : a;
+  area = std::abs(area);
+
+  ScreenTriangle triangle;
+
+  triangle.minX = std::max(0, (int)std::floor(std::min(v0.x, std::min(v1.x, v2.x))));
+  triangle.maxX = std::min((int)m_Width - 1, (int)std::ceil(std::max(v0.x, std::max(v1.x, v2.x))));
+  triangle.minY = std::max(0, (int)std::floor(std::min(v0.y, std::min(v1.y, v2.y))));
+  triangle.maxY = std::min((int)m_Height - 1, (int)std::ceil(std::max(v0.y, std::max(v1.y, v2.y))));
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+
+  const glm::vec3 *vertices[3] = { &v0, &v1, &v2 };
+  for (int i = 0; i < 3; i++)
+  {
+    const glm::vec3 &from = *vertices[i];
+    const glm::vec3 &to = *vertices[(i + 1) % 3];
+
+    triangle.edgeA[i] = from.y - to.y;
+    triangle.edgeB[i] = to.x - from.x;
+    triangle.edgeC[i] = -(triangle.edgeA[i] * from.x + triangle.edgeB[i] * from.y);
+  }
+
+//  z / w is linear in screen space so depth is a plane
+  triangle.depthA = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+  triangle.depthB = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+  triangle.depthC = v0.z - triangle.depthA * v0.x - triangle.depthB * v0.y;
+
+  m_Triangles.push_back(triangle);
+}
+
+void OcclusionCuller::Rasterize()
+{
+  auto start = std::chrono::high_resolution_clock::now();
+
+//  every band owns its rows so no two threads ever write the same pixel
+  const unsigned int bandCount = (m_Height + BAND_ROWS - 1) / BAND_ROWS;
+  m_ThreadPool.ParallelFor(bandCount, 1, [this](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int band = begin; band < end; band++)
+    {
+      RasterizeBand(band * BAND_ROWS, std::min(m_Height, (band + 1) * BAND_ROWS));
+    }
+  });
+
+  m_Statistics.rasterizeMs = MillisecondsSince(start);
+  m_Statistics.occluderTriangles = (unsigned int)m_Triangles.size();
+
+  start = std::chrono::high_resolution_clock::now();
+  BuildHierarchy();
+  m_Statistics.hierarchyMs = MillisecondsSince(start);
+}
+
+void OcclusionCuller::RasterizeBand(unsigned int beginRow, unsigned int endRow)
+{
+  for (const ScreenTriangle &triangle : m_Triangles)
+  {
+    const int firstRow = std::max(triangle.minY, (int)beginRow);
+    const int lastRow = std::min(triangle.maxY, (int)endRow - 1);
+    if (firstRow > lastRow) continue;
+
+//    rows start on a multiple of 4 so the loads stay in the row, the width is padded to 4
+    const int firstColumn = triangle.minX & ~3;
+
+#ifdef OCCLUSION_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 columns = _mm_add_ps(_mm_set1_ps((float)firstColumn), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+
+    __m128 edgeA[3], edgeStep[3];
+    for (int i = 0; i < 3; i++)
+    {
+      edgeA[i] = _mm_set1_ps(triangle.edgeA[i]);
+      edgeStep[i] = _mm_set1_ps(triangle.edgeA[i] * 4.0f);
+    }
+    const __m128 depthA = _mm_set1_ps(triangle.depthA);
+    const __m128 depthStep = _mm_set1_ps(triangle.depthA * 4.0f);
+
+    for (int y = firstRow; y <= lastRow; y++)
+    {
+      const float py = y + 0.5f;
+      float *row = &m_Depth[y * m_Width];
+
+      __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA[0], columns), _mm_set1_ps(triangle.edgeB[0] * py + triangle.edgeC[0]));
+      __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA[1], columns), _mm_set1_ps(triangle.edgeB[1] * py + triangle.edgeC[1]));
+      __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA[2], columns), _mm_set1_ps(triangle.edgeB[2] * py + triangle.edgeC[2]));
+      __m128 z = _mm_add_ps(_mm_mul_ps(depthA, columns), _mm_set1_ps(triangle.depthB * py + triangle.depthC));
+
+      for (int x = firstColumn; x <= triangle.maxX; x += 4)
+      {
+        const __m128 mask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+        if (_mm_movemask_ps(mask))
+        {
+          const __m128 depth = _mm_loadu_ps(row + x);
+          const __m128 closer = _mm_min_ps(depth, z);
+          _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, closer), _mm_andnot_ps(mask, depth)));
+        }
+
+        e0 = _mm_add_ps(e0, edgeStep[0]);
+        e1 = _mm_add_ps(e1, edgeStep[1]);
+        e2 = _mm_add_ps(e2, edgeStep[2]);
+        z = _mm_add_ps(z, depthStep);
+      }
+    }
+#else
+    for (int y = firstRow; y <= lastRow; y++)
+    {
+      const float py = y + 0.5f;
+      float *row = &m_Depth[y * m_Width];
+
+      for (int x = firstColumn; x <= triangle.maxX; x++)
+      {
+        const float px = x + 0.5f;
+
+        if (triangle.edgeA[0] * px + triangle.edgeB[0] * py + triangle.edgeC[0] >= 0.0f &&
+            triangle.edgeA[1] * px + triangle.edgeB[1] * py + triangle.edgeC[1] >= 0.0f &&
+            triangle.edgeA[2] * px + triangle.edgeB[2] * py + triangle.edgeC[2] >= 0.0f)
+        {
+          row[x] = std::min(row[x], triangle.depthA * px + triangle.depthB * py + triangle.depthC);
+        }
+      }
+    }
+#endif
+  }
+}
+
+void OcclusionCuller::BuildHierarchy()
+{
+  for (unsigned int level = 1; level < m_LevelWidths.size(); level++)
+  {
+    const unsigned int width = m_LevelWidths[level], height = m_LevelHeights[level];
+    const unsigned int childWidth = m_LevelWidths[level - 1], childHeight = m_LevelHeights[level - 1];
+
+    const float *childMin = level == 1 ? m_Depth.data() : m_MinDepth[level - 1].data();
+    const float *childMax = level == 1 ? m_Depth.data() : m_MaxDepth[level - 1].data();
+    float *minDepth = m_MinDepth[level].data();
+    float *maxDepth = m_MaxDepth[level].data();
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+      const unsigned int y0 = y * 2, y1 = std::min(y * 2 + 1, childHeight - 1);
+
+      for (unsigned int x = 0; x < width; x++)
+      {
+        const unsigned int x0 = x * 2, x1 = std::min(x * 2 + 1, childWidth - 1);
+
+        minDepth[y * width + x] = std::min(std::min(childMin[y0 * childWidth + x0], childMin[y0 * childWidth + x1]),
+                                           std::min(childMin[y1 * childWidth + x0], childMin[y1 * childWidth + x1]));
+        maxDepth[y * width + x] = std::max(std::max(childMax[y0 * childWidth + x0], childMax[y0 * childWidth + x1]),
+                                           std::max(childMax[y1 * childWidth + x0], childMax[y1 * childWidth + x1]));
+      }
+    }
+  }
+}
+
+bool OcclusionCuller::IsOccluded(const glm::vec3 &min, const glm::vec3 &max)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  m_Statistics.tested++;
+
+//  screen rectangle and nearest depth of the 8 corners
+  float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+  float boxNear = 1.0f;
+  bool crossesNear = false;
+
+  for (int i = 0; i < 8 && !crossesNear; i++)
+  {
+    const glm::vec4 corner(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f);
+    const glm::vec4 clip = m_ViewProjection * corner;
+
+    if (clip.z < -clip.w || clip.w <= 0.0f)
+    {
+      crossesNear = true;
+      break;
+    }
+
+    const float invW = 1.0f / clip.w;
+    const float x = (clip.x * invW * 0.5f + 0.5f) * m_Width;
+    const float y = (clip.y * invW * 0.5f + 0.5f) * m_Height;
+
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+    boxNear = std::min(boxNear, clip.z * invW * 0.5f + 0.5f);
+  }
+
+  bool occluded = false;
+
+  if (!crossesNear)
+  {
+    const int rect[4] = {
+      std::max(0, (int)std::floor(minX)), std::max(0, (int)std::floor(minY)),
+      std::min((int)m_Width - 1, (int)std::floor(maxX)), std::min((int)m_Height - 1, (int)std::floor(maxY))
+    };
+
+    if (rect[0] <= rect[2] && rect[1] <= rect[3])
+    {
+//      start at the level where the rectangle is a couple of texels across
+      const int span = std::max(rect[2] - rect[0], rect[3] - rect[1]) + 1;
+      unsigned int level = 0;
+      while ((span >> level) > 2 && level + 1 < m_LevelWidths.size()) level++;
+
+      occluded = true;
+      for (int y = rect[1] >> level; y <= (rect[3] >> level) && occluded; y++)
+      {
+        for (int x = rect[0] >> level; x <= (rect[2] >> level) && occluded; x++)
+        {
+          occluded = IsTexelOccluded(level, x, y, rect, boxNear);
+        }
+      }
+    }
+  }
+
+  if (occluded) m_Statistics.occluded++;
+  m_Statistics.testMs += MillisecondsSince(start);
+
+  return occluded;
+}
+
+bool OcclusionCuller::IsTexelOccluded(unsigned int level, unsigned int x, unsigned int y, const int *rect, float boxNear) const
+{
+  const unsigned int i = y * m_LevelWidths[level] + x;
+  const float minDepth = level == 0 ? m_Depth[i] : m_MinDepth[level][i];
+  const float maxDepth = level == 0 ? m_Depth[i] : m_MaxDepth[level][i];
+
+//  everything in here is in front of the box
+  if (maxDepth < boxNear) return true;
+
+//  the box is in front of everything in here, and at least one pixel of it is in the rectangle
+  if (boxNear <= minDepth || level == 0) return false;
+
+//  somewhere in between, ask the 4 texels below
+  const unsigned int childLevel = level - 1;
+  for (unsigned int cy = y * 2; cy <= y * 2 + 1 && cy < m_LevelHeights[childLevel]; cy++)
+  {
+    if ((int)((cy + 1) << childLevel) <= rect[1] || (int)(cy << childLevel) > rect[3]) continue;
+
+    for (unsigned int cx = x * 2; cx <= x * 2 + 1 && cx < m_LevelWidths[childLevel]; cx++)
+    {
+      if ((int)((cx + 1) << childLevel) <= rect[0] || (int)(cx << childLevel) > rect[2]) continue;
+
+      if (!IsTexelOccluded(childLevel, cx, cy, rect, boxNear)) return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,120 @@
+//
+//  OcclusionCuller.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef OcclusionCuller_hpp
+#define OcclusionCuller_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+class ThreadPool;
+
+struct OcclusionStatistics
+{
+  unsigned int occluderTriangles = 0;   // after clipping
+  unsigned int tested = 0;
+  unsigned int occluded = 0;
+
+  double rasterizeMs = 0.0;   // occluders into the depth buffer
+  double hierarchyMs = 0.0;   // min/max mips
+  double testMs = 0.0;        // all the IsOccluded calls
+
+  float GetCulledPercent() const { return tested ? 100.0f * occluded / tested : 0.0f; }
+  double GetTotalMs() const { return rasterizeMs + hierarchyMs + testMs; }
+};
+
+/**
+ * software occlusion culling, runs entirely on the CPU
+ *
+ * a few big occluder meshes are rasterized into a small depth buffer, split into row bands over the thread pool
+ * and 4 pixels at a time with SSE. then a min/max depth hierarchy is built from it and object bounds are checked
+ * against that before they go to Renderer::Draw
+ *
+ *   culler.BeginFrame(projection * view);
+ *   culler.AddOccluder(...);   // walls, floors, big props
+ *   culler.Rasterize();
+ *   if (!culler.IsOccluded(min, max)) renderer.Draw(...);
+ *
+ * depth is NDC z mapped to [0, 1], 1 is the far plane
+ */
+class OcclusionCuller
+{
+private:
+//  a clipped occluder triangle ready for the rasterizer, edges are A * x + B * y + C >= 0 inside
+  struct ScreenTriangle
+  {
+    float edgeA[3], edgeB[3], edgeC[3];
+    float depthA, depthB, depthC;     // z = depthA * x + depthB * y + depthC
+    int minX, maxX, minY, maxY;
+  };
+
+  unsigned int m_Width;     // multiple of 4 for the SSE rows
+  unsigned int m_Height;
+
+  std::vector<float> m_Depth;
+
+//  level 0 is the depth buffer itself, every level above halves it
+  std::vector<std::vector<float>> m_MinDepth;
+  std::vector<std::vector<float>> m_MaxDepth;
+  std::vector<unsigned int> m_LevelWidths;
+  std::vector<unsigned int> m_LevelHeights;
+
+  std::vector<ScreenTriangle> m_Triangles;
+  std::vector<glm::vec4> m_ClipVertices;
+  glm::mat4 m_ViewProjection;
+
+  ThreadPool &m_ThreadPool;
+  OcclusionStatistics m_Statistics;
+
+public:
+  OcclusionCuller(unsigned int width = 256, unsigned int height = 128);
+  OcclusionCuller(unsigned int width, unsigned int height, ThreadPool &threadPool);
+
+  /**
+   * clears the depth buffer and the triangles from last frame
+   */
+  void BeginFrame(const glm::mat4 &viewProjection);
+
+  /**
+   * positions are the first 3 floats of every vertex, stride is in floats
+   * both sides of the triangles are drawn so single sided walls work too
+   */
+  void AddOccluder(const float *vertices, unsigned int vertexCount, unsigned int stride,
+                   const unsigned int *indices, unsigned int indexCount, const glm::mat4 &model);
+
+  /**
+   * draws every occluder added since BeginFrame and builds the hierarchy
+   */
+  void Rasterize();
+
+  /**
+   * true only if the world space box is hidden behind the occluders for sure
+   * boxes crossing the near plane or off screen are never occluded - frustum culling handles those
+   */
+  bool IsOccluded(const glm::vec3 &min, const glm::vec3 &max);
+
+  inline const OcclusionStatistics& GetStatistics() const { return m_Statistics; }
+  inline const std::vector<float>& GetDepth() const { return m_Depth; }
+  inline unsigned int GetWidth() const { return m_Width; }
+  inline unsigned int GetHeight() const { return m_Height; }
+  inline unsigned int GetLevelCount() const { return (unsigned int)m_LevelWidths.size(); }
+
+private:
+  void ClipAndSetup(const glm::vec4 *clip);
+  void SetupTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+  void RasterizeBand(unsigned int beginRow, unsigned int endRow);
+  void BuildHierarchy();
+
+  /**
+   * hidden if every pixel of rect in this texel is closer than boxNear, goes down a level when it cant tell
+   */
+  bool IsTexelOccluded(unsigned int level, unsigned int x, unsigned int y, const int *rect, float boxNear) const;
+};
+
+#endif /* OcclusionCuller_hpp */
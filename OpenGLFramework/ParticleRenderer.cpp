@@ -0,0 +1,51 @@
+//
+//  ParticleRenderer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "ParticleRenderer.hpp"
+#include "VertexBufferLayout.hpp"
+
+// unit quad around the particle centre, position + texture coordinate
+static const float s_QuadVertices[] =
+{
+  -0.5f, -0.5f, 0.0f, 0.0f,
+   0.5f, -0.5f, 1.0f, 0.0f,
+   0.5f,  0.5f, 1.0f, 1.0f,
+  -0.5f,  0.5f, 0.0f, 1.0f,
+};
+
+static const unsigned int s_QuadIndices[] =
+{
+  0, 1, 2,
+  2, 3, 0,
+};
+
+ParticleRenderer::ParticleRenderer(unsigned int maxParticles)
+: m_QuadBuffer(s_QuadVertices, sizeof(s_QuadVertices)),
+  m_InstanceBuffer(maxParticles * sizeof(ParticleInstance)),
+  m_IndexBuffer(s_QuadIndices, 6)
+{
+  m_Instances.resize(maxParticles);
+  
+  m_VertexArray.AddBuffer(m_QuadBuffer, Layout<Float2, Float2>());
+  
+//  location 2 - x, y, size, alpha
+  static_assert(Layout<Float4>::Stride == sizeof(ParticleInstance), "instance layout has to match ParticleInstance");
+  m_VertexArray.AddInstanceBuffer(m_InstanceBuffer, Layout<Float4>());
+  
+  m_VertexArray.Unbind();
+}
+
+void ParticleRenderer::Draw(const ParticleSystem &particles, const Shader &shader)
+{
+//  a system bigger than the renderer only gets its first maxParticles drawn
+  const unsigned int count = particles.FillInstances(m_Instances.data(), (unsigned int)m_Instances.size());
+  if (count == 0) return;
+  
+  m_InstanceBuffer.SetData(m_Instances.data(), count * sizeof(ParticleInstance));
+  
+  m_Renderer.DrawInstanced(m_VertexArray, m_IndexBuffer, shader, count);
+}
@@ -0,0 +1,44 @@
+//
+//  ParticleRenderer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef ParticleRenderer_hpp
+#define ParticleRenderer_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "Renderer.h"
+#include "ParticleSystem.hpp"
+
+/**
+ * GL side of the particle engine
+ * every particle is an instance of one textured quad, the instance data is streamed every frame
+ * use with res/shaders/Particle.shader and blending enabled
+ */
+class ParticleRenderer
+{
+private:
+  VertexArray m_VertexArray;
+  VertexBuffer m_QuadBuffer;
+  VertexBuffer m_InstanceBuffer;
+  IndexBuffer m_IndexBuffer;
+  
+  std::vector<ParticleInstance> m_Instances;    // staging for the upload
+  
+  Renderer m_Renderer;
+  
+public:
+  ParticleRenderer(unsigned int maxParticles);
+  
+  /**
+   * shader needs u_MVP and u_Texture set and the texture bound, same as Basic.shader
+   * draws at most maxParticles of the system
+   */
+  void Draw(const ParticleSystem &particles, const Shader &shader);
+};
+
+#endif /* ParticleRenderer_hpp */
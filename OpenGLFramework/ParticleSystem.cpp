@@ -0,0 +1,169 @@
+//
+//  ParticleSystem.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "ParticleSystem.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+  #include <xmmintrin.h>
+  #define PARTICLES_SSE 1
+#endif
+
+// below this many particles a chunk isnt worth handing to another thread
+static const unsigned int MIN_PARTICLES_PER_JOB = 16384;
+
+ParticleSystem::ParticleSystem(unsigned int maxParticles)
+: ParticleSystem(maxParticles, ThreadPool::Get())
+{
+}
+
+ParticleSystem::ParticleSystem(unsigned int maxParticles, ThreadPool &threadPool)
+: m_MaxParticles(maxParticles), m_Count(0), m_Gravity(0.0f, 0.0f), m_RandomState(0x9E3779B9u), m_ThreadPool(threadPool)
+{
+//  allocate everything up front, the update never grows the arrays
+  m_PositionX.resize(maxParticles);
+  m_PositionY.resize(maxParticles);
+  m_VelocityX.resize(maxParticles);
+  m_VelocityY.resize(maxParticles);
+  m_Life.resize(maxParticles);
+  m_InvLifeTime.resize(maxParticles);
+  m_Size.resize(maxParticles);
+}
+
+void ParticleSystem::Emit(const ParticleProps &props, unsigned int count)
+{
+  count = std::min(count, m_MaxParticles - m_Count);
+  
+  for (unsigned int n = 0; n < count; n++)
+  {
+    const unsigned int i = m_Count++;
+    
+    m_PositionX[i] = props.position.x;
+    m_PositionY[i] = props.position.y;
+    m_VelocityX[i] = props.velocity.x + props.velocityVariation.x * Random();
+    m_VelocityY[i] = props.velocity.y + props.velocityVariation.y * Random();
+    m_Life[i] = props.lifeTime + props.lifeTimeVariation * Random();
+    m_InvLifeTime[i] = 1.0f / m_Life[i];
+    m_Size[i] = props.size + props.sizeVariation * Random();
+  }
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+  m_ThreadPool.ParallelFor(m_Count, MIN_PARTICLES_PER_JOB, [this, deltaTime](unsigned int begin, unsigned int end)
+  {
+    Integrate(begin, end, deltaTime);
+  });
+  
+  RemoveDead();
+}
+
+void ParticleSystem::Integrate(unsigned int begin, unsigned int end, float deltaTime)
+{
+  float *px = m_PositionX.data(), *py = m_PositionY.data();
+  float *vx = m_VelocityX.data(), *vy = m_VelocityY.data();
+  float *life = m_Life.data();
+  
+  const float gx = m_Gravity.x * deltaTime;
+  const float gy = m_Gravity.y * deltaTime;
+  
+  unsigned int i = begin;
+  
+#if PARTICLES_SSE
+  const __m128 dt = _mm_set1_ps(deltaTime);
+  const __m128 dvx = _mm_set1_ps(gx);
+  const __m128 dvy = _mm_set1_ps(gy);
+  
+  for (; i + 4 <= end; i += 4)
+  {
+    __m128 velX = _mm_add_ps(_mm_loadu_ps(vx + i), dvx);
+    __m128 velY = _mm_add_ps(_mm_loadu_ps(vy + i), dvy);
+    
+    _mm_storeu_ps(vx + i, velX);
+    _mm_storeu_ps(vy + i, velY);
+    _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, dt)));
+    _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, dt)));
+    _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+  }
+#endif
+  
+//  whatever is left over, or everything without SSE
+  for (; i < end; i++)
+  {
+    vx[i] += gx;
+    vy[i] += gy;
+    px[i] += vx[i] * deltaTime;
+    py[i] += vy[i] * deltaTime;
+    life[i] -= deltaTime;
+  }
+}
+
+/**
+ * swap remove - the last live particle moves into the hole, so the order changes but nothing is shifted
+ */
+void ParticleSystem::RemoveDead()
+{
+  const float *life = m_Life.data();
+  unsigned int i = 0;
+  
+  while (i < m_Count)
+  {
+#if PARTICLES_SSE
+//    skip over 4 live particles at a time
+    if (i + 4 <= m_Count && _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), _mm_setzero_ps())) == 0)
+    {
+      i += 4;
+      continue;
+    }
+#endif
+    
+    if (life[i] > 0.0f)
+    {
+      i++;
+      continue;
+    }
+    
+//    dont advance i, the particle we moved in could be dead as well
+    const unsigned int last = --m_Count;
+    m_PositionX[i] = m_PositionX[last];
+    m_PositionY[i] = m_PositionY[last];
+    m_VelocityX[i] = m_VelocityX[last];
+    m_VelocityY[i] = m_VelocityY[last];
+    m_Life[i] = m_Life[last];
+    m_InvLifeTime[i] = m_InvLifeTime[last];
+    m_Size[i] = m_Size[last];
+  }
+}
+
+unsigned int ParticleSystem::FillInstances(ParticleInstance *out, unsigned int maxCount) const
+{
+  const unsigned int count = std::min(m_Count, maxCount);
+  
+  m_ThreadPool.ParallelFor(count, MIN_PARTICLES_PER_JOB, [this, out](unsigned int begin, unsigned int end)
+  {
+    for (unsigned int i = begin; i < end; i++)
+    {
+      out[i] = { m_PositionX[i], m_PositionY[i], m_Size[i], m_Life[i] * m_InvLifeTime[i] };
+    }
+  });
+  
+  return count;
+}
+
+/**
+ * xorshift - we only need something cheap that looks random
+ */
+float ParticleSystem::Random()
+{
+  m_RandomState ^= m_RandomState << 13;
+  m_RandomState ^= m_RandomState >> 17;
+  m_RandomState ^= m_RandomState << 5;
+  
+  return (float)(m_RandomState & 0xFFFFFF) / (float)0x7FFFFF - 1.0f;
+}
@@ -0,0 +1,97 @@
+//
+//  ParticleSystem.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef ParticleSystem_hpp
+#define ParticleSystem_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+class ThreadPool;
+
+/**
+ * describes a burst of particles
+ * the variations are the maximum random offset either side of the base value
+ */
+struct ParticleProps
+{
+  glm::vec2 position;
+  glm::vec2 velocity;
+  glm::vec2 velocityVariation;
+  float size;
+  float sizeVariation;
+  float lifeTime;           // in seconds
+  float lifeTimeVariation = 0.0f;   // has to stay below lifeTime
+};
+
+/**
+ * what ParticleRenderer streams to the GPU for every particle
+ * x, y, size and the alpha which fades out over the lifetime
+ */
+struct ParticleInstance
+{
+  float x, y;
+  float size;
+  float alpha;
+};
+
+/**
+ * CPU side of the particle engine - it doesnt touch OpenGL so it can run without a context
+ *
+ * particles are kept as a structure of arrays so the update runs 4 particles at a time with SSE
+ * the live particles are always packed in [0, count) - dead ones are swap removed with the last one
+ */
+class ParticleSystem
+{
+private:
+  unsigned int m_MaxParticles;
+  unsigned int m_Count;
+  
+//  one array per attribute
+  std::vector<float> m_PositionX, m_PositionY;
+  std::vector<float> m_VelocityX, m_VelocityY;
+  std::vector<float> m_Life;          // seconds left
+  std::vector<float> m_InvLifeTime;   // 1 / total lifetime, for the fade
+  std::vector<float> m_Size;
+  
+  glm::vec2 m_Gravity;
+  unsigned int m_RandomState;
+  ThreadPool &m_ThreadPool;
+  
+public:
+  ParticleSystem(unsigned int maxParticles);
+  ParticleSystem(unsigned int maxParticles, ThreadPool &threadPool);
+  
+  /**
+   * spawns count particles, anything past the maximum is dropped
+   */
+  void Emit(const ParticleProps &props, unsigned int count = 1);
+  
+  /**
+   * integrate every particle then remove the ones whose life ran out
+   */
+  void Update(float deltaTime);
+  
+  /**
+   * writes up to maxCount instances into out and returns how many - runs across the thread pool
+   */
+  unsigned int FillInstances(ParticleInstance *out, unsigned int maxCount) const;
+  
+  inline void SetGravity(const glm::vec2 &gravity) { m_Gravity = gravity; }
+  
+  inline unsigned int GetCount() const { return m_Count; }
+  inline unsigned int GetMaxParticles() const { return m_MaxParticles; }
+  
+private:
+  void Integrate(unsigned int begin, unsigned int end, float deltaTime);
+  void RemoveDead();
+  float Random();   // -1 to 1
+};
+
+#endif /* ParticleSystem_hpp */
@@ -0,0 +1,63 @@
+//
+//  PoolAllocator.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "PoolAllocator.hpp"
+
+#include <algorithm>
+#include <new>
+
+PoolAllocator::PoolAllocator(size_t blockSize, size_t alignment, unsigned int blocksPerChunk)
+: m_BlocksPerChunk(std::max(blocksPerChunk, 1u)), m_FreeList(nullptr), m_Used(0)
+{
+//  big enough for the free list link and a multiple of the alignment so every block stays aligned
+  blockSize = std::max(blockSize, sizeof(FreeBlock));
+  alignment = std::max(alignment, alignof(FreeBlock));
+  m_BlockSize = (blockSize + alignment - 1) / alignment * alignment;
+}
+
+PoolAllocator::~PoolAllocator()
+{
+  for (void *chunk : m_Chunks)
+  {
+    ::operator delete(chunk);
+  }
+}
+
+void* PoolAllocator::Allocate()
+{
+  if (!m_FreeList) AddChunk();
+  
+  FreeBlock *block = m_FreeList;
+  m_FreeList = block->next;
+  m_Used++;
+  
+  return block;
+}
+
+void PoolAllocator::Free(void *block)
+{
+  if (!block) return;
+  
+  FreeBlock *freed = static_cast<FreeBlock*>(block);
+  freed->next = m_FreeList;
+  m_FreeList = freed;
+  m_Used--;
+}
+
+void PoolAllocator::AddChunk()
+{
+  unsigned char *chunk = static_cast<unsigned char*>(::operator new(m_BlockSize * m_BlocksPerChunk));
+  m_Chunks.push_back(chunk);
+  
+//  link them back to front so the blocks get handed out in address order
+  for (unsigned int i = m_BlocksPerChunk; i > 0; i--)
+  {
+    FreeBlock *block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_BlockSize);
+    block->next = m_FreeList;
+    m_FreeList = block;
+  }
+}
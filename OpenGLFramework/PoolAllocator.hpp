@@ -0,0 +1,96 @@
+//
+//  PoolAllocator.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef PoolAllocator_hpp
+#define PoolAllocator_hpp
+
+#include <stdio.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * fixed size blocks for long lived objects that come and go - textures, meshes, lights
+ * blocks come from chunks that are never given back until the pool goes, a free block holds the link to the next free one
+ * alignment can be up to alignof(std::max_align_t)
+ */
+class PoolAllocator
+{
+private:
+  struct FreeBlock
+  {
+    FreeBlock *next;
+  };
+  
+  size_t m_BlockSize;
+  unsigned int m_BlocksPerChunk;
+  
+  FreeBlock *m_FreeList;
+  std::vector<void*> m_Chunks;
+  unsigned int m_Used;
+  
+public:
+  PoolAllocator(size_t blockSize, size_t alignment = alignof(std::max_align_t), unsigned int blocksPerChunk = 64);
+  ~PoolAllocator();
+  
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+  
+  void* Allocate();
+  void Free(void *block);
+  
+  inline unsigned int GetUsed() const { return m_Used; }
+  inline unsigned int GetCapacity() const { return (unsigned int)m_Chunks.size() * m_BlocksPerChunk; }
+  
+private:
+  void AddChunk();
+};
+
+
+/**
+ * PoolAllocator that constructs and destructs Ts
+ */
+template<typename T>
+class ObjectPool
+{
+private:
+  PoolAllocator m_Pool;
+  
+public:
+  ObjectPool(unsigned int objectsPerChunk = 64)
+  : m_Pool(sizeof(T), alignof(T), objectsPerChunk)
+  {
+  }
+  
+  template<typename... Args>
+  T* Create(Args&&... args)
+  {
+    void *block = m_Pool.Allocate();
+    try
+    {
+      return new (block) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      m_Pool.Free(block);
+      throw;
+    }
+  }
+  
+  void Destroy(T *object)
+  {
+    if (!object) return;
+    
+    object->~T();
+    m_Pool.Free(object);
+  }
+  
+  inline unsigned int GetUsed() const { return m_Pool.GetUsed(); }
+  inline unsigned int GetCapacity() const { return m_Pool.GetCapacity(); }
+};
+
+#endif /* PoolAllocator_hpp */
@@ -0,0 +1,471 @@
+//
+//  RenderGraph.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Renderer.h"
+#include "Texture.hpp"
+#include "FrameBuffer.hpp"
+
+/*************************** BUILDER AND CONTEXT START ***************************/
+
+RenderPassBuilder::RenderPassBuilder(RenderGraph &graph, unsigned int pass)
+: m_Graph(graph), m_Pass(pass)
+{
+}
+
+RenderResource RenderPassBuilder::Read(RenderResource resource)
+{
+  m_Graph.m_Passes[m_Pass].reads.push_back(resource);
+  m_Graph.m_Resources[resource].readers.push_back(m_Pass);
+  return resource;
+}
+
+RenderResource RenderPassBuilder::Write(RenderResource resource)
+{
+  m_Graph.m_Passes[m_Pass].writes.push_back(resource);
+  m_Graph.m_Resources[resource].writers.push_back(m_Pass);
+  return resource;
+}
+
+void RenderPassBuilder::HasSideEffects()
+{
+  m_Graph.m_Passes[m_Pass].sideEffects = true;
+}
+
+RenderPassContext::RenderPassContext(const RenderGraph &graph)
+: m_Graph(graph)
+{
+}
+
+Texture* RenderPassContext::GetTexture(RenderResource resource) const
+{
+  return m_Graph.m_Resources[resource].texture;
+}
+
+/*************************** BUILDER AND CONTEXT END ***************************/
+
+RenderGraph::RenderGraph()
+: m_Compiled(false), m_Allocated(false), m_Statistics()
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+RenderResource RenderGraph::AddResource(const std::string &name, ResourceType type, bool imported)
+{
+  Resource resource;
+  resource.name = name;
+  resource.type = type;
+  resource.imported = imported;
+  resource.desc = { 0, 0, 0, 0, 0 };
+  resource.texture = nullptr;
+  resource.physical = -1;
+  resource.firstUse = -1;
+  resource.lastUse = -1;
+  
+  m_Resources.push_back(resource);
+  m_Compiled = false;
+  return (RenderResource)m_Resources.size() - 1;
+}
+
+RenderResource RenderGraph::CreateTexture(const std::string &name, const RenderTargetDesc &desc)
+{
+  RenderResource resource = AddResource(name, ResourceType::TEXTURE, false);
+  m_Resources[resource].desc = desc;
+  return resource;
+}
+
+RenderResource RenderGraph::ImportTexture(const std::string &name, Texture &texture)
+{
+  RenderResource resource = AddResource(name, ResourceType::TEXTURE, true);
+  m_Resources[resource].texture = &texture;
+  return resource;
+}
+
+RenderResource RenderGraph::ImportBuffer(const std::string &name)
+{
+  return AddResource(name, ResourceType::BUFFER, true);
+}
+
+RenderResource RenderGraph::ImportBackbuffer()
+{
+  RenderResource resource = AddResource("Backbuffer", ResourceType::BACKBUFFER, true);
+  m_Outputs.push_back(resource);
+  return resource;
+}
+
+void RenderGraph::AddPass(const std::string &name, const SetupFunction &setup, const ExecuteFunction &execute)
+{
+  Pass pass;
+  pass.name = name;
+  pass.execute = execute;
+  pass.sideEffects = false;
+  pass.culled = false;
+  pass.viewportWidth = 0;
+  pass.viewportHeight = 0;
+  m_Passes.push_back(std::move(pass));
+  
+  RenderPassBuilder builder(*this, (unsigned int)m_Passes.size() - 1);
+  setup(builder);
+  
+  m_Compiled = false;
+}
+
+void RenderGraph::MarkOutput(RenderResource resource)
+{
+  m_Outputs.push_back(resource);
+  m_Compiled = false;
+}
+
+bool RenderGraph::Compile()
+{
+  m_Allocated = false;
+  m_Physical.clear();
+  for (auto &pass : m_Passes) pass.frameBuffer.reset();
+  
+  if (!SortPasses())
+  {
+    std::cout << "RenderGraph: the passes have a cycle" << std::endl;
+    return false;
+  }
+  
+  CullPasses();
+  ComputeLifetimes();
+  AssignPhysicalTargets();
+  
+  m_Compiled = true;
+  return true;
+}
+
+/**
+ * Kahn's algorithm, ties go to the pass declared first
+ * every write starts a new version of a resource - a reader waits for the last writer declared before it
+ * and the next writer waits for all the readers of the version it replaces
+ * readers declared before the first writer read the first version, so passes can still be declared out of order
+ */
+bool RenderGraph::SortPasses()
+{
+  const unsigned int passCount = (unsigned int)m_Passes.size();
+  std::vector<std::vector<unsigned int>> edges(passCount);
+  std::vector<unsigned int> incoming(passCount, 0);
+  
+  auto addEdge = [&](unsigned int from, unsigned int to)
+  {
+    if (from == to) return;
+    edges[from].push_back(to);
+    incoming[to]++;
+  };
+  
+  for (const auto &resource : m_Resources)
+  {
+//    every pass that touches the resource once, in declaration order
+    std::vector<unsigned int> accesses(resource.writers);
+    accesses.insert(accesses.end(), resource.readers.begin(), resource.readers.end());
+    std::sort(accesses.begin(), accesses.end());
+    accesses.erase(std::unique(accesses.begin(), accesses.end()), accesses.end());
+    
+    int lastWriter = -1;
+    std::vector<unsigned int> readers;    // of the version lastWriter made
+    
+    for (unsigned int pass : accesses)
+    {
+//      read-modify-write passes count as writers, the edge from the last writer covers their read
+      const bool writes = std::find(resource.writers.begin(), resource.writers.end(), pass) != resource.writers.end();
+      
+      if (!writes)
+      {
+        if (lastWriter >= 0) addEdge(lastWriter, pass);
+        readers.push_back(pass);
+        continue;
+      }
+      
+      if (lastWriter < 0)
+      {
+        for (unsigned int reader : readers) addEdge(pass, reader);
+      }
+      else
+      {
+        addEdge(lastWriter, pass);
+        for (unsigned int reader : readers) addEdge(reader, pass);
+        readers.clear();
+      }
+      
+      lastWriter = pass;
+    }
+  }
+  
+  m_Order.clear();
+  std::vector<unsigned int> ready;
+  for (unsigned int i = 0; i < passCount; i++)
+  {
+    if (incoming[i] == 0) ready.push_back(i);
+  }
+  
+  while (!ready.empty())
+  {
+    auto first = std::min_element(ready.begin(), ready.end());
+    unsigned int pass = *first;
+    ready.erase(first);
+    m_Order.push_back(pass);
+    
+    for (unsigned int next : edges[pass])
+    {
+      if (--incoming[next] == 0) ready.push_back(next);
+    }
+  }
+  
+  return m_Order.size() == passCount;
+}
+
+/**
+ * walk backwards from the outputs, a pass survives if something that survives reads what it writes
+ */
+void RenderGraph::CullPasses()
+{
+  std::vector<bool> needed(m_Resources.size(), false);
+  for (RenderResource output : m_Outputs) needed[output] = true;
+  
+//  anything outside the graph can be looked at by someone else
+  for (unsigned int i = 0; i < m_Resources.size(); i++)
+  {
+    if (m_Resources[i].imported) needed[i] = true;
+  }
+  
+  for (auto it = m_Order.rbegin(); it != m_Order.rend(); ++it)
+  {
+    Pass &pass = m_Passes[*it];
+    
+    bool used = pass.sideEffects;
+    for (RenderResource resource : pass.writes) used = used || needed[resource];
+    
+    pass.culled = !used;
+    if (pass.culled) continue;
+    
+    for (RenderResource resource : pass.reads) needed[resource] = true;
+  }
+  
+  unsigned int culled = 0;
+  std::vector<unsigned int> order;
+  for (unsigned int pass : m_Order)
+  {
+    if (m_Passes[pass].culled) culled++;
+    else order.push_back(pass);
+  }
+  m_Order.swap(order);
+  
+  m_Statistics.passCount = (unsigned int)m_Order.size();
+  m_Statistics.culledPasses = culled;
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+  for (auto &resource : m_Resources)
+  {
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+  }
+  
+  for (int position = 0; position < (int)m_Order.size(); position++)
+  {
+    const Pass &pass = m_Passes[m_Order[position]];
+    
+    auto use = [&](RenderResource index)
+    {
+      Resource &resource = m_Resources[index];
+      if (resource.firstUse < 0) resource.firstUse = position;
+      resource.lastUse = position;
+    };
+    
+    for (RenderResource resource : pass.reads) use(resource);
+    for (RenderResource resource : pass.writes) use(resource);
+  }
+}
+
+/**
+ * greedy interval colouring - targets in order of first use take the first free texture with the same description
+ */
+void RenderGraph::AssignPhysicalTargets()
+{
+  std::vector<RenderResource> transient;
+  for (RenderResource i = 0; i < m_Resources.size(); i++)
+  {
+    Resource &resource = m_Resources[i];
+    resource.physical = -1;
+    
+    if (resource.type == ResourceType::TEXTURE && !resource.imported)
+    {
+      resource.texture = nullptr;
+      if (resource.firstUse >= 0) transient.push_back(i);
+    }
+  }
+  
+  std::sort(transient.begin(), transient.end(), [this](RenderResource a, RenderResource b)
+  {
+    return m_Resources[a].firstUse < m_Resources[b].firstUse;
+  });
+  
+  m_Statistics.transientTargets = (unsigned int)transient.size();
+  m_Statistics.transientBytes = 0;
+  m_Statistics.aliasedBytes = 0;
+  
+  for (RenderResource index : transient)
+  {
+    Resource &resource = m_Resources[index];
+    const unsigned long long bytes = (unsigned long long)resource.desc.width * resource.desc.height * GetBytesPerPixel(resource.desc.internalFormat);
+    m_Statistics.transientBytes += bytes;
+    
+    for (unsigned int i = 0; i < m_Physical.size(); i++)
+    {
+      if (m_Physical[i].freeAfter < resource.firstUse && m_Physical[i].desc == resource.desc)
+      {
+        resource.physical = i;
+        break;
+      }
+    }
+    
+    if (resource.physical < 0)
+    {
+      PhysicalTarget target;
+      target.desc = resource.desc;
+      m_Physical.push_back(std::move(target));
+      resource.physical = (int)m_Physical.size() - 1;
+      m_Statistics.aliasedBytes += bytes;
+    }
+    
+    m_Physical[resource.physical].freeAfter = resource.lastUse;
+  }
+  
+  m_Statistics.physicalTargets = (unsigned int)m_Physical.size();
+}
+
+void RenderGraph::Allocate()
+{
+  for (auto &target : m_Physical)
+  {
+    const RenderTargetDesc &desc = target.desc;
+    target.texture = std::make_unique<Texture>(desc.width, desc.height, desc.internalFormat, desc.format, desc.type);
+  }
+  
+  for (auto &resource : m_Resources)
+  {
+    if (resource.physical >= 0) resource.texture = m_Physical[resource.physical].texture.get();
+  }
+  
+//  one framebuffer per pass with everything it writes attached
+  for (unsigned int index : m_Order)
+  {
+    Pass &pass = m_Passes[index];
+    
+    for (RenderResource write : pass.writes)
+    {
+      const Resource &resource = m_Resources[write];
+      if (resource.type != ResourceType::TEXTURE || !resource.texture) continue;
+      
+      if (!pass.frameBuffer) pass.frameBuffer = std::make_unique<FrameBuffer>();
+      
+      const bool depth = resource.desc.format == GL_DEPTH_COMPONENT || resource.desc.format == GL_DEPTH_STENCIL;
+      if (depth)
+        pass.frameBuffer->AttachDepth(*resource.texture);
+      else
+        pass.frameBuffer->AttachColor(*resource.texture);
+      
+      pass.viewportWidth = resource.texture->GetWidth();
+      pass.viewportHeight = resource.texture->GetHeight();
+    }
+    
+    if (pass.frameBuffer && !pass.frameBuffer->IsComplete())
+    {
+      std::cout << "RenderGraph: framebuffer of pass " << pass.name << " is incomplete" << std::endl;
+    }
+  }
+  
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  m_Allocated = true;
+}
+
+void RenderGraph::Execute()
+{
+  if (!m_Compiled && !Compile()) return;
+  if (!m_Allocated) Allocate();
+  
+//  whatever the window viewport is now is what the backbuffer passes get
+  int viewport[4];
+  GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+  
+  RenderPassContext context(*this);
+  
+  for (unsigned int index : m_Order)
+  {
+    const Pass &pass = m_Passes[index];
+    
+    if (pass.frameBuffer)
+    {
+      pass.frameBuffer->Bind();
+      GLCall(glViewport(0, 0, pass.viewportWidth, pass.viewportHeight));
+    }
+    else
+    {
+      GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+      GLCall(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+    }
+    
+    pass.execute(context);
+  }
+  
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  GLCall(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+}
+
+std::vector<std::string> RenderGraph::GetExecutionOrder() const
+{
+  std::vector<std::string> names;
+  for (unsigned int index : m_Order) names.push_back(m_Passes[index].name);
+  return names;
+}
+
+std::vector<std::string> RenderGraph::GetCulledPasses() const
+{
+  std::vector<std::string> names;
+  for (const auto &pass : m_Passes)
+  {
+    if (pass.culled) names.push_back(pass.name);
+  }
+  return names;
+}
+
+int RenderGraph::GetPhysicalIndex(RenderResource resource) const
+{
+  return m_Resources[resource].physical;
+}
+
+unsigned int RenderGraph::GetBytesPerPixel(unsigned int internalFormat)
+{
+  switch (internalFormat)
+  {
+    case GL_R8:                   return 1;
+    case GL_R16F:                 return 2;
+    case GL_RG8:                  return 2;
+    case GL_RGBA8:                return 4;
+    case GL_R32F:                 return 4;
+    case GL_RG16F:                return 4;
+    case GL_RGB10_A2:             return 4;
+    case GL_R11F_G11F_B10F:       return 4;
+    case GL_DEPTH_COMPONENT24:    return 4;   // drivers pad it to 32 bits
+    case GL_DEPTH_COMPONENT32F:   return 4;
+    case GL_DEPTH24_STENCIL8:     return 4;
+    case GL_RGBA16F:              return 8;
+    case GL_RG32F:                return 8;
+    case GL_RGBA32F:              return 16;
+  }
+  return 4;
+}
@@ -0,0 +1,215 @@
+//
+//  RenderGraph.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef RenderGraph_hpp
+#define RenderGraph_hpp
+
+#include <stdio.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Texture;
+class FrameBuffer;
+
+// index of a texture or buffer inside its graph
+typedef unsigned int RenderResource;
+
+/**
+ * size and format of a transient render target
+ */
+struct RenderTargetDesc
+{
+  int width, height;
+  unsigned int internalFormat;  // e.g. GL_RGBA16F, GL_DEPTH_COMPONENT32F
+  unsigned int format;          // e.g. GL_RGBA, GL_DEPTH_COMPONENT
+  unsigned int type;            // e.g. GL_FLOAT
+  
+  bool operator==(const RenderTargetDesc &other) const
+  {
+    return width == other.width && height == other.height && internalFormat == other.internalFormat
+        && format == other.format && type == other.type;
+  }
+};
+
+class RenderGraph;
+
+/**
+ * handed to the setup function of a pass to declare what it touches
+ */
+class RenderPassBuilder
+{
+private:
+  RenderGraph &m_Graph;
+  unsigned int m_Pass;
+  
+public:
+  RenderPassBuilder(RenderGraph &graph, unsigned int pass);
+  
+  RenderResource Read(RenderResource resource);
+  RenderResource Write(RenderResource resource);
+  
+  /**
+   * the pass writes something outside the graph (e.g. a readback) so it is never culled
+   */
+  void HasSideEffects();
+};
+
+/**
+ * handed to the execute function of a pass - the framebuffer is already bound
+ */
+class RenderPassContext
+{
+private:
+  const RenderGraph &m_Graph;
+  
+public:
+  RenderPassContext(const RenderGraph &graph);
+  
+  /**
+   * the texture behind a resource this pass reads, nullptr for buffers and the backbuffer
+   */
+  Texture* GetTexture(RenderResource resource) const;
+};
+
+/**
+ * Multi pass frames described as passes and the resources they read and write
+ *
+ * Compile() orders the passes so every read sees the last write declared before it and no write
+ * lands before the reads of the previous contents are done, drops the passes nothing needs and gives transient render targets whose lifetimes dont overlap the same texture
+ * Compile() doesnt touch OpenGL so the statistics can be looked at without a context
+ *
+ * OpenGL cant place two textures in the same memory, so aliasing is done by sharing one
+ * texture object between transient targets of identical size and format
+ */
+class RenderGraph
+{
+public:
+  typedef std::function<void(RenderPassBuilder&)> SetupFunction;
+  typedef std::function<void(const RenderPassContext&)> ExecuteFunction;
+  
+  struct Statistics
+  {
+    unsigned int passCount;
+    unsigned int culledPasses;
+    unsigned int transientTargets;
+    unsigned int physicalTargets;
+    unsigned long long transientBytes;   // every transient target with its own memory
+    unsigned long long aliasedBytes;     // what the shared textures actually take
+  };
+  
+private:
+  enum class ResourceType
+  {
+    TEXTURE, BUFFER, BACKBUFFER
+  };
+  
+  struct Resource
+  {
+    std::string name;
+    ResourceType type;
+    bool imported;
+    RenderTargetDesc desc;
+    Texture *texture;             // imported texture, or the physical one after Compile
+    int physical;                 // index into m_Physical, -1 if not transient
+    int firstUse, lastUse;        // positions in m_Order
+    std::vector<unsigned int> writers;
+    std::vector<unsigned int> readers;
+  };
+  
+  struct Pass
+  {
+    std::string name;
+    ExecuteFunction execute;
+    std::vector<RenderResource> reads;
+    std::vector<RenderResource> writes;
+    bool sideEffects;
+    bool culled;
+    std::unique_ptr<FrameBuffer> frameBuffer;
+    int viewportWidth, viewportHeight;
+  };
+  
+  struct PhysicalTarget
+  {
+    RenderTargetDesc desc;
+    int freeAfter;                // last pass position that uses it
+    std::unique_ptr<Texture> texture;
+  };
+  
+  std::vector<Resource> m_Resources;
+  std::vector<Pass> m_Passes;
+  std::vector<unsigned int> m_Order;    // pass indices in execution order, culled passes left out
+  std::vector<PhysicalTarget> m_Physical;
+  std::vector<RenderResource> m_Outputs;
+  
+  bool m_Compiled;
+  bool m_Allocated;
+  Statistics m_Statistics;
+  
+  friend class RenderPassBuilder;
+  friend class RenderPassContext;
+  
+public:
+  RenderGraph();
+  ~RenderGraph();
+  
+  /**
+   * a render target owned by the graph that only lives for the frame
+   */
+  RenderResource CreateTexture(const std::string &name, const RenderTargetDesc &desc);
+  
+  /**
+   * resources that live outside the graph - only used to order the passes
+   */
+  RenderResource ImportTexture(const std::string &name, Texture &texture);
+  RenderResource ImportBuffer(const std::string &name);
+  RenderResource ImportBackbuffer();
+  
+  void AddPass(const std::string &name, const SetupFunction &setup, const ExecuteFunction &execute);
+  
+  /**
+   * what the frame is for - passes that dont lead to an output are culled
+   * the backbuffer is always an output
+   */
+  void MarkOutput(RenderResource resource);
+  
+  /**
+   * false if the passes have a cycle
+   */
+  bool Compile();
+  
+  /**
+   * creates the textures and framebuffers the first time, then runs the passes in order
+   */
+  void Execute();
+  
+  inline const Statistics& GetStatistics() const { return m_Statistics; }
+  
+  /**
+   * pass names in execution order, for debugging
+   */
+  std::vector<std::string> GetExecutionOrder() const;
+  std::vector<std::string> GetCulledPasses() const;
+  
+  /**
+   * which shared texture a transient target ended up in, -1 if it was never used
+   */
+  int GetPhysicalIndex(RenderResource resource) const;
+  
+  static unsigned int GetBytesPerPixel(unsigned int internalFormat);
+  
+private:
+  RenderResource AddResource(const std::string &name, ResourceType type, bool imported);
+  bool SortPasses();
+  void CullPasses();
+  void ComputeLifetimes();
+  void AssignPhysicalTargets();
+  void Allocate();
+};
+
+#endif /* RenderGraph_hpp */
@@ -0,0 +1,95 @@
+//
+//  RenderQueue.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "RenderQueue.hpp"
+#include "Renderer.h"
+#include "AllocationTracker.hpp"
+
+#include <algorithm>
+
+RenderQueue::RenderQueue(size_t frameMemory)
+: m_FrameAllocator(frameMemory), m_Commands(m_FrameAllocator, 256), m_FrameAllocations(0), m_FrameAllocatedBytes(0)
+{
+}
+
+void RenderQueue::BeginFrame()
+{
+  m_FrameAllocator.Reset();
+  m_Commands = FrameArray<DrawCommand>(m_FrameAllocator, 256);
+  
+  m_FrameAllocations = AllocationTracker::GetAllocations();
+  m_FrameAllocatedBytes = AllocationTracker::GetAllocatedBytes();
+}
+
+void RenderQueue::Submit(const VertexArray &va, const IndexBuffer &ib, Shader &shader, const glm::mat4 &mvp, unsigned int count, unsigned int firstIndex)
+{
+  m_Commands.Push({ &va, &ib, &shader, mvp, count ? count : ib.GetCount(), firstIndex });
+}
+
+void RenderQueue::EndFrame()
+{
+  m_Statistics.drawCalls = m_Commands.GetSize();
+  m_Statistics.shaderBinds = 0;
+  m_Statistics.vertexArrayBinds = 0;
+  
+//  program switches cost the most so they go in the top bits, the index keeps the sort stable
+  struct SortKey
+  {
+    unsigned long long key;
+    unsigned int index;
+  };
+  
+  SortKey *keys = m_FrameAllocator.Allocate<SortKey>(m_Commands.GetSize());
+  for (unsigned int i = 0; i < m_Commands.GetSize(); i++)
+  {
+    keys[i].key = ((unsigned long long)m_Commands[i].shader->GetRendererID() << 32) | m_Commands[i].va->GetRendererID();
+    keys[i].index = i;
+  }
+  std::sort(keys, keys + m_Commands.GetSize(), [](const SortKey &a, const SortKey &b)
+  {
+    return a.key != b.key ? a.key < b.key : a.index < b.index;
+  });
+  
+  const Shader *boundShader = nullptr;
+  const VertexArray *boundVertexArray = nullptr;
+  const IndexBuffer *boundIndexBuffer = nullptr;
+  
+  for (unsigned int i = 0; i < m_Commands.GetSize(); i++)
+  {
+    const DrawCommand &command = m_Commands[keys[i].index];
+    
+    if (command.shader != boundShader)
+    {
+      command.shader->Bind();
+      boundShader = command.shader;
+      m_Statistics.shaderBinds++;
+    }
+    if (command.va != boundVertexArray)
+    {
+      command.va->Bind();
+      boundVertexArray = command.va;
+      boundIndexBuffer = nullptr;   // the element buffer binding is part of the VAO
+      m_Statistics.vertexArrayBinds++;
+    }
+    if (command.ib != boundIndexBuffer)
+    {
+      command.ib->Bind();
+      boundIndexBuffer = command.ib;
+    }
+    
+    command.shader->SetUniformMat4f("u_MVP", command.mvp);
+    
+    GLCall(glDrawElements(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, (const void*)(command.firstIndex * sizeof(unsigned int))));
+  }
+  
+//  the commands go with the next Reset, start an empty list so a stray Submit still has somewhere to go
+  m_Commands = FrameArray<DrawCommand>(m_FrameAllocator, 0);
+  
+  m_Statistics.frameMemory = m_FrameAllocator.GetUsed();
+  m_Statistics.allocations = AllocationTracker::GetAllocations() - m_FrameAllocations;
+  m_Statistics.allocatedBytes = AllocationTracker::GetAllocatedBytes() - m_FrameAllocatedBytes;
+}
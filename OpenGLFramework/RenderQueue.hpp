@@ -0,0 +1,92 @@
+//
+//  RenderQueue.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef RenderQueue_hpp
+#define RenderQueue_hpp
+
+#include <stdio.h>
+
+#include "glm/glm.hpp"
+
+#include "FrameAllocator.hpp"
+
+class VertexArray;
+class IndexBuffer;
+class Shader;
+
+/**
+ * a draw queued with Submit, lives in the frame allocator
+ */
+struct DrawCommand
+{
+  const VertexArray *va;
+  const IndexBuffer *ib;
+  Shader *shader;
+  glm::mat4 mvp;
+  unsigned int count;
+  unsigned int firstIndex;
+};
+
+struct RenderQueueStatistics
+{
+  unsigned int drawCalls = 0;
+  unsigned int shaderBinds = 0;
+  unsigned int vertexArrayBinds = 0;
+  
+//  between BeginFrame and EndFrame, steady state should be 0
+  unsigned long long allocations = 0;
+  unsigned long long allocatedBytes = 0;
+  
+  size_t frameMemory = 0;   // used in the frame allocator
+};
+
+/**
+ * draws queued for the end of the frame, the commands and anything else per frame live in a FrameAllocator
+ * kept apart from Renderer so the renderers that only draw through one dont carry an arena each
+ *
+ *   queue.BeginFrame();
+ *   queue.Submit(va, ib, shader, projection * view * model);
+ *   ...
+ *   queue.EndFrame();
+ */
+class RenderQueue
+{
+private:
+  FrameAllocator m_FrameAllocator;
+  FrameArray<DrawCommand> m_Commands;
+  RenderQueueStatistics m_Statistics;
+  
+  unsigned long long m_FrameAllocations;    // AllocationTracker counts at BeginFrame
+  unsigned long long m_FrameAllocatedBytes;
+  
+public:
+  RenderQueue(size_t frameMemory = 1024 * 1024);
+  
+  /**
+   * resets the frame allocator and starts counting heap allocations for the frame
+   */
+  void BeginFrame();
+  
+  /**
+   * queue a draw for EndFrame, the mvp is copied into frame memory and set as u_MVP
+   * count 0 draws the whole index buffer
+   */
+  void Submit(const VertexArray &va, const IndexBuffer &ib, Shader &shader, const glm::mat4 &mvp, unsigned int count = 0, unsigned int firstIndex = 0);
+  
+  /**
+   * sorts the queued draws by shader then vertex array and draws them, only binding what changed
+   */
+  void EndFrame();
+  
+  /**
+   * memory that is valid until the next BeginFrame
+   */
+  inline FrameAllocator& GetFrameAllocator() { return m_FrameAllocator; }
+  inline const RenderQueueStatistics& GetStatistics() const { return m_Statistics; }
+};
+
+#endif /* RenderQueue_hpp */
@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 #include "Renderer.h"
+#include "VertexFormatCache.hpp"
 #include <iostream>
 
 /**
@@ -40,6 +41,43 @@ void Renderer::Draw(const VertexArray &va, const IndexBuffer &ib, const Shader &
   GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
 }
 
+void Renderer::Draw(VertexFormatCache &formats, const VertexLayoutInfo &layout, const VertexBuffer &vb, const IndexBuffer &ib, const Shader &shader) const
+{
+  shader.Bind();
+  formats.Bind(layout, vb);
+  ib.Bind();
+  
+  GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+}
+
+void Renderer::DrawRange(VertexFormatCache &formats, const VertexLayoutInfo &layout, const VertexBuffer &vb, const IndexBuffer &ib, const Shader &shader,
+                         unsigned int count, unsigned int firstIndex, int baseVertex) const
+{
+  shader.Bind();
+  formats.Bind(layout, vb);
+  ib.Bind();
+  
+  GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(unsigned int)), baseVertex));
+}
+
+void Renderer::DrawRange(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, unsigned int count, unsigned int firstIndex, int baseVertex) const
+{
+  shader.Bind();
+  va.Bind();
+  ib.Bind();
+  
+  GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(unsigned int)), baseVertex));
+}
+
+void Renderer::DrawInstanced(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, unsigned int instanceCount) const
+{
+  shader.Bind();
+  va.Bind();
+  ib.Bind();
+  
+  GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount));
+}
+
 void Renderer::Clear() const
 {
   GLCall(glClear(GL_COLOR_BUFFER_BIT));
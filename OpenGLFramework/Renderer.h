@@ -13,9 +13,21 @@
 #include "IndexBuffer.hpp"
 #include "Shader.hpp"
 
+class VertexFormatCache;
+struct VertexLayoutInfo;
+
 // the macros for OpenGL debugging that runs our functions
-// this creates a debugger
-#define ASSERT(x) if (!(x)) asm{int 3};
+// this creates a debugger, asm{int 3} only builds with clang on x86 so pick the break per compiler
+#if defined(_MSC_VER)
+  #define DEBUG_BREAK() __debugbreak()
+#elif defined(__i386__) || defined(__x86_64__)
+  #define DEBUG_BREAK() __asm__ volatile("int $0x03")
+#else
+  #include <signal.h>
+  #define DEBUG_BREAK() raise(SIGTRAP)
+#endif
+
+#define ASSERT(x) if (!(x)) DEBUG_BREAK();
 
 #if DEBUG
   #define GLCall(x) GLClearError();\
@@ -44,6 +56,25 @@ private:
 public:
   void Clear() const;
   void Draw(const VertexArray &va, const IndexBuffer &ib, const Shader &shader) const;
+  
+  /**
+   * draw part of the index buffer - for when several meshes share one vertex and index buffer
+   * baseVertex is added to every index
+   */
+  void DrawRange(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, unsigned int count, unsigned int firstIndex, int baseVertex = 0) const;
+  
+  /**
+   * draw a vertex buffer through the cached VAO for its layout instead of a VertexArray per buffer
+   * DrawRange draws part of the index buffer like the VertexArray version above
+   */
+  void Draw(VertexFormatCache &formats, const VertexLayoutInfo &layout, const VertexBuffer &vb, const IndexBuffer &ib, const Shader &shader) const;
+  void DrawRange(VertexFormatCache &formats, const VertexLayoutInfo &layout, const VertexBuffer &vb, const IndexBuffer &ib, const Shader &shader,
+                 unsigned int count, unsigned int firstIndex, int baseVertex = 0) const;
+  
+  /**
+   * draw the whole index buffer instanceCount times, for attributes added with VertexArray::AddInstanceBuffer
+   */
+  void DrawInstanced(const VertexArray &va, const IndexBuffer &ib, const Shader &shader, unsigned int instanceCount) const;
 };
 
 
@@ -9,7 +9,6 @@
 #include <string>
 #include <cstring>
 #include <fstream>
-#include <sstream>
 
 #include "Shader.hpp"
 #include "Renderer.h"
@@ -21,7 +20,14 @@ Shader::Shader(const std::string& filepath)
   //  read in the shaders
   ShaderProgramSource source = ParseShader(filepath);
   
-  m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+  if (!source.ComputeSource.empty())
+  {
+    m_RendererID = CreateComputeShader(source.ComputeSource);
+  }
+  else
+  {
+    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+  }
 }
 
 Shader::~Shader()
@@ -42,37 +48,77 @@ void Shader::Unbind() const
 /*************************** UNIFORM FUNCTIONS START ***************************/
 
 
-void Shader::SetUniform4f(const std::string &name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform4f(const char *name, float v0, float v1, float v2, float v3)
 {
   GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
 }
 
-void Shader::SetUniform1f(const std::string &name, float value)
+void Shader::SetUniform1f(const char *name, float value)
 {
   GLCall(glUniform1f(GetUniformLocation(name), value));
 }
 
-void Shader::SetUniform1i(const std::string &name, int value)
+void Shader::SetUniform2f(const char *name, float v0, float v1)
+{
+  GLCall(glUniform2f(GetUniformLocation(name), v0, v1));
+}
+
+void Shader::SetUniform3f(const char *name, float v0, float v1, float v2)
+{
+  GLCall(glUniform3f(GetUniformLocation(name), v0, v1, v2));
+}
+
+void Shader::SetUniform1i(const char *name, int value)
 {
   GLCall(glUniform1i(GetUniformLocation(name), value));
 }
 
-void Shader::SetUniformMat4f(const std::string &name, const glm::mat4 &matrix)
+void Shader::SetUniformMat4f(const char *name, const glm::mat4 &matrix)
 {
   GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
+void Shader::SetUniform1ui(const char *name, unsigned int value)
+{
+  GLCall(glUniform1ui(GetUniformLocation(name), value));
+}
+
+/**
+ * for vec4 arrays, values has to hold 4 * count floats
+ */
+void Shader::SetUniform4fv(const char *name, unsigned int count, const float *values)
+{
+  GLCall(glUniform4fv(GetUniformLocation(name), count, values));
+}
+
 /*************************** UNIFORM FUNCTIONS END ***************************/
 
-int Shader::GetUniformLocation(const std::string &name)
+void Shader::Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+  GLCall(glDispatchCompute(groupsX, groupsY, groupsZ));
+}
+
+int Shader::GetUniformLocation(const char *name)
 {
-  if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
+//  FNV-1a, the names are short and a shader only has a handful
+  unsigned long long hash = 14695981039346656037ull;
+  for (const char *c = name; *c; c++)
+  {
+    hash = (hash ^ (unsigned char)*c) * 1099511628211ull;
+  }
+  
+  auto cached = m_UniformLocationCache.find(hash);
+  if (cached != m_UniformLocationCache.end())
   {
 //    if cached return the cached value
-    return m_UniformLocationCache[name];
+    if (!strcmp(cached->second.name.c_str(), name)) return cached->second.location;
+    
+//    another name with the same hash got the slot first, ask OpenGL every time for this one
+    GLCall(int location = glGetUniformLocation(m_RendererID, name));
+    return location;
   }
   
-  GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
+  GLCall(int location = glGetUniformLocation(m_RendererID, name));
   
   if (location == -1)
   {
@@ -80,7 +126,7 @@ int Shader::GetUniformLocation(const std::string &name)
   }
 
 //   cache it
-  m_UniformLocationCache[name] = location;
+  m_UniformLocationCache[hash] = { name, location };
   
   
   return location;
@@ -96,11 +142,11 @@ ShaderProgramSource Shader::ParseShader(const std::string& filepath)
   
   enum class ShaderType
   {
-    NONE = -1, VERTEX = 0, FRAGMENT = 1
+    NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2
   };
   
   std::string line;
-  std::stringstream ss[2];  // one for vertex shader and one for fragment shader
+  std::string sources[3];   // one for vertex shader, one for fragment shader and one for compute shader
   auto type = ShaderType::NONE;
   while (getline(stream, line))
   {
@@ -116,15 +162,21 @@ ShaderProgramSource Shader::ParseShader(const std::string& filepath)
         // set mode to fragment
         type = ShaderType::FRAGMENT;
       }
+      else if (line.find("compute") != std::string::npos)
+      {
+        // set mode to compute
+        type = ShaderType::COMPUTE;
+      }
     }
-    else
+    else if (type != ShaderType::NONE)
     {
-      ss[(int)type] << line << "\n";
+      sources[(int)type] += line;
+      sources[(int)type] += '\n';
     }
   }
   
-  //  set the first one to VertexSource and second one to FragmentSource
-  return {ss[0].str(), ss[1].str()};
+  //  set the first one to VertexSource, second one to FragmentSource and the third to ComputeSource
+  return {std::move(sources[0]), std::move(sources[1]), std::move(sources[2])};
 }
 
 
@@ -151,14 +203,13 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string &source)
   {
     int length;
     glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
-    char *message = new char[length];
-    glGetShaderInfoLog(id, length, &length, message);
+    std::string message(length, '\0');
+    glGetShaderInfoLog(id, length, &length, &message[0]);
+    message.resize(length);
     
-    std::cout << "Failed to compile the " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader" << std::endl;
+    std::cout << "Failed to compile the " << (type == GL_VERTEX_SHADER ? "vertex" : type == GL_FRAGMENT_SHADER ? "fragment" : "compute") << " shader" << std::endl;
     std::cout << message << std::endl;
     
-    delete [] message;
-    
     glDeleteShader(id); // because compilation did not work
     return 0;
   }
@@ -193,3 +244,23 @@ unsigned int Shader::CreateShader(const std::string &vertexShader, const std::st
   
   return program;
 }
+
+/**
+ * compute programs only have the one stage
+ * needs an OpenGL 4.3 context
+ */
+unsigned int Shader::CreateComputeShader(const std::string &computeShader)
+{
+  unsigned int program = glCreateProgram();
+  
+  unsigned int cs = CompileShader(GL_COMPUTE_SHADER, computeShader);
+  
+  glAttachShader(program, cs);
+  
+  glLinkProgram(program);
+  glValidateProgram(program);
+  
+  glDeleteShader(cs);
+  
+  return program;
+}
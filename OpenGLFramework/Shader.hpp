@@ -20,6 +20,7 @@ struct ShaderProgramSource
 {
   std::string VertexSource;
   std::string FragmentSource;
+  std::string ComputeSource;    // if set the program is a compute program and the others are ignored
 };
 
 
@@ -29,7 +30,14 @@ private:
   unsigned int m_RendererID;
 
 //  caching synstem for uniforms
-  std::unordered_map<std::string, int> m_UniformLocationCache;
+//  keyed by a hash of the name so a lookup doesnt have to build a std::string every call
+//  the name is kept so a hit can be checked against it, two names with the same hash dont share a location
+  struct CachedUniform
+  {
+    std::string name;
+    int location;
+  };
+  std::unordered_map<unsigned long long, CachedUniform> m_UniformLocationCache;
   
 public:
   Shader(const std::string& filepath);
@@ -44,16 +52,28 @@ public:
   /**
    * for our textures
    */
-  void SetUniform1i(const std::string &name, int value);
-  void SetUniform4f(const std::string &name, float v0, float v1, float f2, float f3);
-  void SetUniform1f(const std::string &name, float value);
-  void SetUniformMat4f(const std::string &name, const glm::mat4 &matrix);
+  void SetUniform1i(const char *name, int value);
+  void SetUniform4f(const char *name, float v0, float v1, float f2, float f3);
+  void SetUniform1f(const char *name, float value);
+  void SetUniform2f(const char *name, float v0, float v1);
+  void SetUniform3f(const char *name, float v0, float v1, float v2);
+  void SetUniformMat4f(const char *name, const glm::mat4 &matrix);
+  void SetUniform1ui(const char *name, unsigned int value);
+  void SetUniform4fv(const char *name, unsigned int count, const float *values);
+  
+  /**
+   * only for compute shaders - the shader has to be bound first
+   */
+  void Dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1) const;
+  
+  inline unsigned int GetRendererID() const { return m_RendererID; }
   
 private:
   ShaderProgramSource ParseShader(const std::string& filepath);
   unsigned int CompileShader(unsigned int type, const std::string &source);
   unsigned int CreateShader(const std::string &vertexShader, const std::string &fragmentShader);
-  int GetUniformLocation(const std::string &name);
+  unsigned int CreateComputeShader(const std::string &computeShader);
+  int GetUniformLocation(const char *name);
 };
 
 #endif /* Shader_hpp */
@@ -0,0 +1,51 @@
+//
+//  ShaderStorageBuffer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "ShaderStorageBuffer.hpp"
+#include "Renderer.h"
+
+ShaderStorageBuffer::ShaderStorageBuffer(const void* data, unsigned int size)
+: m_Size(size)
+{
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID));
+//  dynamic since we rewrite it from the CPU or the GPU every frame
+  GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW));
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer()
+{
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void ShaderStorageBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+  ASSERT(offset + size <= m_Size);
+  
+  GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID));
+  GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data));
+}
+
+void ShaderStorageBuffer::BindBase(unsigned int binding) const
+{
+  GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_RendererID));
+}
+
+void ShaderStorageBuffer::BindIndirect() const
+{
+  GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID));
+}
+
+void ShaderStorageBuffer::Bind() const
+{
+  GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID));
+}
+
+void ShaderStorageBuffer::Unbind() const
+{
+  GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+}
@@ -0,0 +1,43 @@
+//
+//  ShaderStorageBuffer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef ShaderStorageBuffer_hpp
+#define ShaderStorageBuffer_hpp
+
+#include <stdio.h>
+
+/**
+ * Represents a GL_SHADER_STORAGE_BUFFER - requires an OpenGL 4.3 context
+ * the same buffer can also be bound as the GL_DRAW_INDIRECT_BUFFER
+ * so a compute shader can write draw commands straight into it
+ */
+class ShaderStorageBuffer
+{
+private:
+  unsigned int m_RendererID;
+  unsigned int m_Size;      // in bytes
+  
+public:
+  ShaderStorageBuffer(const void* data, unsigned int size);
+  ~ShaderStorageBuffer();
+  
+  /**
+   * overwrite part of the buffer, offset and size are in bytes
+   */
+  void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+  
+//  binds to the indexed binding point matching layout(binding = x) in the shader
+  void BindBase(unsigned int binding) const;
+  void BindIndirect() const;
+  
+  void Bind() const;
+  void Unbind() const;
+  
+  inline unsigned int GetSize() const { return m_Size; }
+};
+
+#endif /* ShaderStorageBuffer_hpp */
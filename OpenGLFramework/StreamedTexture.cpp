@@ -0,0 +1,127 @@
+//
+//  StreamedTexture.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "StreamedTexture.hpp"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+StreamedTexture::StreamedTexture(const std::string &path, int width, int height, unsigned int pinnedSize)
+: m_RendererID(0), m_FilePath(path), m_Width(std::max(width, 1)), m_Height(std::max(height, 1))
+{
+  m_LevelCount = 1;
+  while ((std::max(m_Width, m_Height) >> m_LevelCount) > 0) m_LevelCount++;
+  
+  m_PinnedLevel = 0;
+  while (std::max(GetLevelWidth(m_PinnedLevel), GetLevelHeight(m_PinnedLevel)) > (int)pinnedSize) m_PinnedLevel++;
+  
+  m_ResidentLevel = m_LevelCount;
+  m_PendingLevel = m_LevelCount;
+  m_PendingBytes = 0;
+  m_LoadFailed = false;
+  m_WantedLevel = m_LevelCount;
+  m_LevelLastUsed.resize(m_LevelCount, 0);
+  
+  GLCall(glGenTextures(1, &m_RendererID));
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_LevelCount - 1));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1));
+  
+//  grey 1x1 until the real pixels come in so it can be drawn straight away
+  const unsigned char grey[4] = { 128, 128, 128, 255 };
+  GLCall(glTexImage2D(GL_TEXTURE_2D, m_LevelCount - 1, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey));
+  
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+StreamedTexture::~StreamedTexture()
+{
+  GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+void StreamedTexture::RecordUse(float screenSize)
+{
+  const float texels = (float)std::max(m_Width, m_Height);
+  
+  unsigned int level = 0;
+  if (screenSize < texels)
+  {
+    level = (unsigned int)std::floor(std::log2(texels / std::max(screenSize, 1.0f)));
+  }
+  
+  m_WantedLevel = std::min(m_WantedLevel, std::min(level, m_LevelCount - 1));
+}
+
+void StreamedTexture::Bind(unsigned int slot) const
+{
+  GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+}
+
+void StreamedTexture::Unbind() const
+{
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
+int StreamedTexture::GetLevelWidth(unsigned int level) const
+{
+  return std::max(m_Width >> level, 1);
+}
+
+int StreamedTexture::GetLevelHeight(unsigned int level) const
+{
+  return std::max(m_Height >> level, 1);
+}
+
+unsigned long long StreamedTexture::GetLevelBytes(unsigned int level) const
+{
+  return (unsigned long long)GetLevelWidth(level) * GetLevelHeight(level) * 4;
+}
+
+unsigned long long StreamedTexture::GetBytesFrom(unsigned int level) const
+{
+  unsigned long long bytes = 0;
+  for (unsigned int l = level; l < m_LevelCount; l++) bytes += GetLevelBytes(l);
+  return bytes;
+}
+
+void StreamedTexture::UploadLevel(unsigned int level, const unsigned char *pixels)
+{
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  
+  GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, GetLevelWidth(level), GetLevelHeight(level), 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+  GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+  
+//  only sample from it once its in
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level));
+  
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+  
+  m_ResidentLevel = level;
+}
+
+void StreamedTexture::EvictLevel()
+{
+  const unsigned int level = m_ResidentLevel;
+  m_ResidentLevel++;
+  
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  
+//  move the base up first so the texture never samples an empty level
+//  a 0x0 image is the only way to give a single level back without sparse textures
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_ResidentLevel));
+  GLCall(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+  
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
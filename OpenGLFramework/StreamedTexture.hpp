@@ -0,0 +1,83 @@
+//
+//  StreamedTexture.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef StreamedTexture_hpp
+#define StreamedTexture_hpp
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/**
+ * a mipmapped RGBA8 texture that only has some of its levels on the GPU
+ * levels from m_ResidentLevel down to the 1x1 one are uploaded, GL_TEXTURE_BASE_LEVEL points at m_ResidentLevel so it always samples as complete
+ * level 0 is the full size image
+ *
+ * made and owned by TextureStreamer, which does all the loading and evicting
+ */
+class StreamedTexture
+{
+private:
+  unsigned int m_RendererID;
+  std::string m_FilePath;
+  int m_Width, m_Height;
+  
+  unsigned int m_LevelCount;
+  unsigned int m_ResidentLevel;   // finest level on the GPU, m_LevelCount while there is only the grey placeholder
+  unsigned int m_PinnedLevel;     // this level and the coarser ones are never evicted
+  unsigned int m_PendingLevel;    // finest level a load is in flight for, m_LevelCount when nothing is
+  unsigned long long m_PendingBytes;    // budget set aside for that load and not uploaded yet, 0 for the pinned levels
+  bool m_LoadFailed;              // so a missing file isnt asked for again every frame
+  
+//  filled in by RecordUse during the frame
+  unsigned int m_WantedLevel;     // m_LevelCount when it wasnt used
+  std::vector<unsigned long long> m_LevelLastUsed;    // frame every level was last needed, for the LRU
+  
+  friend class TextureStreamer;
+  
+public:
+  StreamedTexture(const std::string &path, int width, int height, unsigned int pinnedSize);
+  ~StreamedTexture();
+  
+  /**
+   * call when drawing with the texture, screenSize is roughly how many pixels it covers along its longer side
+   * picks the level that gets about one texel per pixel
+   */
+  void RecordUse(float screenSize);
+  
+  void Bind(unsigned int slot = 0) const;
+  void Unbind() const;
+  
+  inline int GetWidth() const { return m_Width; }
+  inline int GetHeight() const { return m_Height; }
+  inline unsigned int GetLevelCount() const { return m_LevelCount; }
+  inline unsigned int GetResidentLevel() const { return m_ResidentLevel; }
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+  
+  /**
+   * bytes of all the levels from level down to 1x1
+   */
+  unsigned long long GetBytesFrom(unsigned int level) const;
+  inline unsigned long long GetResidentBytes() const { return GetBytesFrom(m_ResidentLevel); }
+  
+  unsigned long long GetLevelBytes(unsigned int level) const;
+  int GetLevelWidth(unsigned int level) const;
+  int GetLevelHeight(unsigned int level) const;
+  
+private:
+  /**
+   * has to be the level just finer than the resident ones, pixels are tightly packed RGBA8
+   */
+  void UploadLevel(unsigned int level, const unsigned char *pixels);
+  
+  /**
+   * drops the finest resident level
+   */
+  void EvictLevel();
+};
+
+#endif /* StreamedTexture_hpp */
@@ -0,0 +1,121 @@
+//
+//  TextRenderer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "TextRenderer.hpp"
+#include "VertexBufferLayout.hpp"
+
+#include <algorithm>
+
+// position, texture coordinate, colour
+using TextLayout = Layout<Float2, Float2, UByte4Norm>;
+static_assert(TextLayout::Stride == sizeof(TextVertex), "TextLayout has to match TextVertex");
+
+/**
+ * 0 1 2, 2 3 0 for every quad
+ */
+std::vector<unsigned int> TextRenderer::BuildQuadIndices(unsigned int maxGlyphs)
+{
+  std::vector<unsigned int> indices(maxGlyphs * 6);
+  for (unsigned int i = 0; i < maxGlyphs; i++)
+  {
+    indices[i * 6 + 0] = i * 4 + 0;
+    indices[i * 6 + 1] = i * 4 + 1;
+    indices[i * 6 + 2] = i * 4 + 2;
+    indices[i * 6 + 3] = i * 4 + 2;
+    indices[i * 6 + 4] = i * 4 + 3;
+    indices[i * 6 + 5] = i * 4 + 0;
+  }
+  return indices;
+}
+
+TextRenderer::TextRenderer(unsigned int maxGlyphs)
+: m_MaxGlyphs(maxGlyphs),
+  m_IndexBuffer(BuildQuadIndices(maxGlyphs).data(), maxGlyphs * 6),
+  m_Shader("res/shaders/SDFText.shader"),
+  m_GlyphsLastFrame(0)
+{
+  m_Shader.Bind();
+  m_Shader.SetUniform1i("u_Atlas", 0);
+  m_Shader.Unbind();
+}
+
+TextRenderer::~TextRenderer()
+{
+//  the batch buffers go before m_Formats, drop their VAOs while the names are still ours
+  for (auto &batch : m_Batches)
+  {
+    m_Formats.Forget(*batch.buffer);
+  }
+}
+
+TextRenderer::Batch& TextRenderer::GetBatch(Font &font)
+{
+//  a handful of fonts at most so a linear search is fine
+  for (auto &batch : m_Batches)
+  {
+    if (batch.font == &font) return batch;
+  }
+  
+  const GlyphAtlas &atlas = font.GetAtlas();
+  
+  m_Batches.push_back({ &font, std::make_unique<Texture>(atlas.GetWidth(), atlas.GetHeight(), GL_R8, GL_RED),
+                        std::make_unique<VertexBuffer>(m_MaxGlyphs * 4 * sizeof(TextVertex)), {} });
+  return m_Batches.back();
+}
+
+void TextRenderer::DrawText(Font &font, const std::string &text, float x, float y, float scale, const glm::vec4 &color)
+{
+  Batch &batch = GetBatch(font);
+  
+  unsigned int rgba = (unsigned int)(std::min(std::max(color.x, 0.0f), 1.0f) * 255.0f)
+                    | (unsigned int)(std::min(std::max(color.y, 0.0f), 1.0f) * 255.0f) << 8
+                    | (unsigned int)(std::min(std::max(color.z, 0.0f), 1.0f) * 255.0f) << 16
+                    | (unsigned int)(std::min(std::max(color.w, 0.0f), 1.0f) * 255.0f) << 24;
+  
+  font.Layout(text, x, y, scale, rgba, batch.vertices);
+}
+
+void TextRenderer::Flush(const glm::mat4 &mvp)
+{
+  m_GlyphsLastFrame = 0;
+  
+  m_Shader.Bind();
+  m_Shader.SetUniformMat4f("u_MVP", mvp);
+  
+  for (auto &batch : m_Batches)
+  {
+    GlyphAtlas &atlas = batch.font->GetAtlas();
+    
+//    only the rows that got new glyphs go up
+    if (atlas.IsDirty())
+    {
+      const int minY = atlas.GetDirtyMinY();
+      const int maxY = atlas.GetDirtyMaxY();
+      batch.atlas->SetData(0, minY, atlas.GetWidth(), maxY - minY, atlas.GetPixels() + minY * atlas.GetWidth());
+      atlas.ClearDirty();
+    }
+    
+    const unsigned int glyphs = (unsigned int)batch.vertices.size() / 4;
+    
+    if (glyphs > 0)
+    {
+      batch.atlas->Bind(0);
+      
+//      one draw per font unless it has more glyphs than the buffer holds
+      for (unsigned int first = 0; first < glyphs; first += m_MaxGlyphs)
+      {
+        unsigned int count = std::min(m_MaxGlyphs, glyphs - first);
+        batch.buffer->SetData(&batch.vertices[first * 4], count * 4 * sizeof(TextVertex));
+        m_Renderer.DrawRange(m_Formats, TextLayout(), *batch.buffer, m_IndexBuffer, m_Shader, count * 6, 0);
+      }
+    }
+    
+    m_GlyphsLastFrame += glyphs;
+    batch.vertices.clear();
+    atlas.NextFrame();
+  }
+}
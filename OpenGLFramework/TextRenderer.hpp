@@ -0,0 +1,69 @@
+//
+//  TextRenderer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef TextRenderer_hpp
+#define TextRenderer_hpp
+
+#include <stdio.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "Texture.hpp"
+#include "Font.hpp"
+#include "VertexFormatCache.hpp"
+
+/**
+ * batches text per font and draws every font with one call
+ * every font streams its glyph quads into its own vertex buffer, the index buffer is a fixed quad pattern
+ * the buffers share one layout so switching fonts only rebinds the buffer through the VertexFormatCache
+ */
+class TextRenderer
+{
+private:
+  struct Batch
+  {
+    Font *font;
+    std::unique_ptr<Texture> atlas;
+    std::unique_ptr<VertexBuffer> buffer;
+    std::vector<TextVertex> vertices;
+  };
+  
+  unsigned int m_MaxGlyphs;   // per draw call
+  
+  VertexFormatCache m_Formats;
+  IndexBuffer m_IndexBuffer;
+  Shader m_Shader;
+  
+  std::vector<Batch> m_Batches;   // one per font, kept between frames so the vectors keep their capacity
+  unsigned int m_GlyphsLastFrame;
+  
+  Renderer m_Renderer;
+  
+public:
+  TextRenderer(unsigned int maxGlyphs = 16384);
+  ~TextRenderer();
+  
+  /**
+   * queue a string, x and y is the start of the baseline in the space of the mvp given to Flush
+   */
+  void DrawText(Font &font, const std::string &text, float x, float y, float scale, const glm::vec4 &color);
+  
+  /**
+   * upload what changed in the atlases and draw everything queued this frame
+   */
+  void Flush(const glm::mat4 &mvp);
+  
+  inline unsigned int GetGlyphsLastFrame() const { return m_GlyphsLastFrame; }
+  
+private:
+  Batch& GetBatch(Font &font);
+  static std::vector<unsigned int> BuildQuadIndices(unsigned int maxGlyphs);
+};
+
+#endif /* TextRenderer_hpp */
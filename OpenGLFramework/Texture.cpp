@@ -9,7 +9,7 @@
 #include "vendor/stb_image/stb_image.h"
 
 Texture::Texture(const std::string &path)
-: m_RenderID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
+: m_RenderID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_Format(GL_RGBA), m_Type(GL_UNSIGNED_BYTE)
 {
 //  load the image
   stbi_set_flip_vertically_on_load(1);
@@ -42,11 +42,38 @@ Texture::Texture(const std::string &path)
   }
 }
 
+Texture::Texture(int width, int height, unsigned int internalFormat, unsigned int format, unsigned int type)
+: m_RenderID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(0), m_Format(format), m_Type(type)
+{
+  GLCall(glGenTextures(1, &m_RenderID));
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RenderID));
+  
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+  
+//  allocate only, nullptr means there is nothing to copy yet
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr));
+  
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
 Texture::~Texture()
 {
   GLCall(glDeleteTextures(1, &m_RenderID));
 }
 
+void Texture::SetData(int x, int y, int width, int height, const void *data)
+{
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RenderID));
+  
+//  rows of single channel textures arent 4 byte aligned
+  GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+  GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, m_Format, m_Type, data));
+  GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+}
+
 void Texture::Bind(unsigned int slot) const
 {
 //  specify a texture slot
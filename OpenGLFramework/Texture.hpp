@@ -18,11 +18,22 @@ private:
   std::string m_FilePath;
   unsigned char* m_LocalBuffer;   // local storage for texture
   int m_Width, m_Height, m_BPP;   // BPP == Bits Per Picture
+  unsigned int m_Format, m_Type;  // what SetData expects
   
 public:
   Texture(const std::string &path);
+  
+  /**
+   * empty texture to be filled with SetData - e.g. GL_R8 / GL_RED for single channel data
+   */
+  Texture(int width, int height, unsigned int internalFormat, unsigned int format, unsigned int type = GL_UNSIGNED_BYTE);
   ~Texture();
   
+  /**
+   * upload a region of the texture, data is tightly packed width * height pixels in the format the texture was created with
+   */
+  void SetData(int x, int y, int width, int height, const void *data);
+  
   /**
    * optional parameter allows you to specify the slot you want to bind the texture to
    * because we have the ability to bind more than 1 texture bind
@@ -34,6 +45,7 @@ public:
   
   inline int GetWidth() const { return m_Width; }
   inline int GetHeight() const { return m_Height; }
+  inline unsigned int GetRendererID() const { return m_RenderID; }
   
   
 };
@@ -0,0 +1,56 @@
+//
+//  TextureBuffer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "TextureBuffer.hpp"
+#include "Renderer.h"
+
+TextureBuffer::TextureBuffer(unsigned int internalFormat, unsigned int size)
+: m_InternalFormat(internalFormat), m_Size(size)
+{
+  GLCall(glGenBuffers(1, &m_BufferID));
+  GLCall(glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID));
+  GLCall(glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW));
+  
+  GLCall(glGenTextures(1, &m_TextureID));
+  GLCall(glBindTexture(GL_TEXTURE_BUFFER, m_TextureID));
+  GLCall(glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, m_BufferID));
+  
+  GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+  GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+}
+
+TextureBuffer::~TextureBuffer()
+{
+  GLCall(glDeleteTextures(1, &m_TextureID));
+  GLCall(glDeleteBuffers(1, &m_BufferID));
+}
+
+void TextureBuffer::SetData(const void *data, unsigned int size)
+{
+  GLCall(glBindBuffer(GL_TEXTURE_BUFFER, m_BufferID));
+  
+//  double it when it grows so we dont reallocate every frame, otherwise orphan and refill
+  if (size > m_Size)
+  {
+    while (m_Size < size) m_Size *= 2;
+  }
+  GLCall(glBufferData(GL_TEXTURE_BUFFER, m_Size, nullptr, GL_STREAM_DRAW));
+  GLCall(glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data));
+  
+  GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+}
+
+void TextureBuffer::Bind(unsigned int slot) const
+{
+  GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+  GLCall(glBindTexture(GL_TEXTURE_BUFFER, m_TextureID));
+}
+
+void TextureBuffer::Unbind() const
+{
+  GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+}
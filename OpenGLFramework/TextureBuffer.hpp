@@ -0,0 +1,40 @@
+//
+//  TextureBuffer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef TextureBuffer_hpp
+#define TextureBuffer_hpp
+
+#include <stdio.h>
+
+/**
+ * a buffer object read in shaders through a GL_TEXTURE_BUFFER with texelFetch
+ * works on 3.3 contexts, unlike shader storage buffers
+ */
+class TextureBuffer
+{
+private:
+  unsigned int m_BufferID;
+  unsigned int m_TextureID;
+  unsigned int m_InternalFormat;  // e.g. GL_R32UI, GL_RGBA32F
+  unsigned int m_Size;            // in bytes
+  
+public:
+  TextureBuffer(unsigned int internalFormat, unsigned int size);
+  ~TextureBuffer();
+  
+  /**
+   * replaces the contents, the storage grows if data doesnt fit
+   */
+  void SetData(const void *data, unsigned int size);
+  
+  void Bind(unsigned int slot = 0) const;
+  void Unbind() const;
+  
+  inline unsigned int GetSize() const { return m_Size; }
+};
+
+#endif /* TextureBuffer_hpp */
@@ -0,0 +1,349 @@
+//
+//  TextureStreamer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "TextureStreamer.hpp"
+#include "vendor/stb_image/stb_image.h"
+
+#include <algorithm>
+#include <iostream>
+
+TextureStreamer::TextureStreamer(unsigned long long budgetBytes, unsigned long long uploadBytesPerFrame, unsigned int pinnedSize)
+: m_Budget(budgetBytes), m_UploadLimit(uploadBytesPerFrame), m_PinnedSize(pinnedSize), m_Frame(0), m_ResidentBytes(0), m_PendingBytes(0),
+  m_Quit(false), m_BandwidthStart(std::chrono::high_resolution_clock::now()), m_BandwidthBytes(0)
+{
+  m_Loader = std::thread(&TextureStreamer::LoaderLoop, this);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Quit = true;
+  }
+  m_WorkReady.notify_all();
+
+  m_Loader.join();
+  
+  for (StreamedTexture *texture : m_Textures)
+  {
+    m_TexturePool.Destroy(texture);
+  }
+}
+
+StreamedTexture& TextureStreamer::Load(const std::string &path)
+{
+  int width = 1, height = 1, channels = 0;
+  if (!stbi_info(path.c_str(), &width, &height, &channels))
+  {
+    std::cout << "TextureStreamer: cant read " << path << std::endl;
+    width = height = 1;
+  }
+
+  m_Textures.push_back(m_TexturePool.Create(path, width, height, m_PinnedSize));
+  StreamedTexture &texture = *m_Textures.back();
+
+//  the small levels go in straight away and dont count against the budget checks
+  texture.m_PendingLevel = texture.m_PinnedLevel;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Requests.push_back({ &texture, path, texture.m_PinnedLevel, texture.m_LevelCount });
+  }
+  m_WorkReady.notify_one();
+
+  return texture;
+}
+
+void TextureStreamer::Update()
+{
+  m_Frame++;
+  m_Statistics.uploadedBytes = 0;
+  m_Statistics.evictedBytes = 0;
+
+//  stamp what the draws asked for so the LRU knows, a texture wanting level 2 needs 2 and everything coarser
+  for (StreamedTexture *texture : m_Textures)
+  {
+    for (unsigned int level = texture->m_WantedLevel; level < texture->m_LevelCount; level++)
+    {
+      texture->m_LevelLastUsed[level] = m_Frame;
+    }
+  }
+
+  UploadLoaded();
+
+//  the budget might have been lowered
+  while (m_ResidentBytes > m_Budget && EvictOne(nullptr)) {}
+
+  RequestWanted();
+
+//  counters
+  m_Statistics.textures = (unsigned int)m_Textures.size();
+  m_Statistics.fullyResident = 0;
+  m_Statistics.pendingLoads = 0;
+  m_Statistics.wantedBytes = 0;
+
+  for (StreamedTexture *texture : m_Textures)
+  {
+    if (texture->m_ResidentLevel == 0) m_Statistics.fullyResident++;
+    if (texture->m_PendingLevel < texture->m_LevelCount) m_Statistics.pendingLoads++;
+    if (texture->m_WantedLevel < texture->m_LevelCount) m_Statistics.wantedBytes += texture->GetBytesFrom(texture->m_WantedLevel);
+
+    texture->m_WantedLevel = texture->m_LevelCount;
+  }
+
+  m_Statistics.residentBytes = m_ResidentBytes;
+  m_Statistics.budgetBytes = m_Budget;
+  m_Statistics.totalUploadedBytes += m_Statistics.uploadedBytes;
+  m_Statistics.totalEvictedBytes += m_Statistics.evictedBytes;
+
+  m_BandwidthBytes += m_Statistics.uploadedBytes;
+  const auto now = std::chrono::high_resolution_clock::now();
+  const double seconds = std::chrono::duration<double>(now - m_BandwidthStart).count();
+  if (seconds >= 1.0)
+  {
+    m_Statistics.uploadMegabytesPerSecond = m_BandwidthBytes / seconds / (1024.0 * 1024.0);
+    m_BandwidthBytes = 0;
+    m_BandwidthStart = now;
+  }
+}
+
+void TextureStreamer::UploadLoaded()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    while (!m_Loaded.empty())
+    {
+      m_Uploads.push_back(std::move(m_Loaded.front()));
+      m_Loaded.pop_front();
+    }
+  }
+
+  unsigned long long uploaded = 0;
+
+  while (!m_Uploads.empty())
+  {
+    LoadResult &result = m_Uploads.front();
+    StreamedTexture *texture = result.texture;
+
+    auto discard = [&](unsigned int count)
+    {
+      for (unsigned int i = 0; i < count; i++)
+      {
+        m_Statistics.totalDiscardedBytes += texture->GetLevelBytes(result.firstLevel + (unsigned int)result.levels.size() - 1);
+        result.levels.pop_back();
+      }
+    };
+
+    if (result.levels.empty()) texture->m_LoadFailed = true;
+
+//    coarsest first so every upload extends the chain that is already there
+//    anything that no longer lines up was evicted in the meantime and gets asked for again later
+    bool outOfTime = false;
+    while (!result.levels.empty())
+    {
+      const unsigned int level = result.firstLevel + (unsigned int)result.levels.size() - 1;
+      if (level + 1 != texture->m_ResidentLevel)
+      {
+        discard(level < texture->m_ResidentLevel ? (unsigned int)result.levels.size() : 1);
+        continue;
+      }
+
+      const unsigned long long bytes = texture->GetLevelBytes(level);
+
+//      at least one level goes up every frame so a huge level cant get stuck
+      if (uploaded > 0 && uploaded + bytes > m_UploadLimit)
+      {
+        outOfTime = true;
+        break;
+      }
+
+//      make room, the pinned levels go in regardless
+      while (m_ResidentBytes + bytes > m_Budget && EvictOne(texture)) {}
+      if (m_ResidentBytes + bytes > m_Budget && level < texture->m_PinnedLevel)
+      {
+        discard((unsigned int)result.levels.size());
+        break;
+      }
+
+      texture->UploadLevel(level, result.levels.back().data());
+      result.levels.pop_back();
+
+      m_ResidentBytes += bytes;
+      uploaded += bytes;
+
+//      resident now, so no longer set aside
+      const unsigned long long reserved = std::min(bytes, texture->m_PendingBytes);
+      texture->m_PendingBytes -= reserved;
+      m_PendingBytes -= reserved;
+    }
+
+    if (outOfTime) break;
+
+//    whatever was set aside for levels that got thrown away goes back
+    m_PendingBytes -= texture->m_PendingBytes;
+    texture->m_PendingBytes = 0;
+    texture->m_PendingLevel = texture->m_LevelCount;
+    m_Uploads.pop_front();
+  }
+
+  m_Statistics.uploadedBytes = uploaded;
+}
+
+void TextureStreamer::RequestWanted()
+{
+//  how much could be made resident without touching anything used this frame or promised to a load in flight
+  unsigned long long available = m_Budget > m_ResidentBytes + m_PendingBytes ? m_Budget - m_ResidentBytes - m_PendingBytes : 0;
+
+  std::vector<StreamedTexture*> wanted;
+  for (StreamedTexture *texture : m_Textures)
+  {
+    for (unsigned int level = texture->m_ResidentLevel; level < texture->m_PinnedLevel && texture->m_LevelLastUsed[level] < m_Frame; level++)
+    {
+      available += texture->GetLevelBytes(level);
+    }
+
+    if (texture->m_WantedLevel < texture->m_ResidentLevel && texture->m_PendingLevel == texture->m_LevelCount && !texture->m_LoadFailed)
+    {
+      wanted.push_back(texture);
+    }
+  }
+
+//  the ones furthest from what they want go first
+  std::sort(wanted.begin(), wanted.end(), [](const StreamedTexture *a, const StreamedTexture *b)
+  {
+    return a->m_ResidentLevel - a->m_WantedLevel > b->m_ResidentLevel - b->m_WantedLevel;
+  });
+
+  bool requested = false;
+  for (StreamedTexture *texture : wanted)
+  {
+//    settle for a coarser level when the wanted one wont fit
+    unsigned int level = texture->m_WantedLevel;
+    unsigned long long bytes = texture->GetBytesFrom(level) - texture->GetResidentBytes();
+    while (bytes > available && level < texture->m_ResidentLevel)
+    {
+      level++;
+      bytes = texture->GetBytesFrom(level) - texture->GetResidentBytes();
+    }
+    if (level >= texture->m_ResidentLevel) continue;
+
+    available -= bytes;
+    texture->m_PendingLevel = level;
+    texture->m_PendingBytes = bytes;
+    m_PendingBytes += bytes;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Requests.push_back({ texture, texture->m_FilePath, level, texture->m_ResidentLevel });
+    requested = true;
+  }
+
+  if (requested) m_WorkReady.notify_one();
+}
+
+bool TextureStreamer::EvictOne(const StreamedTexture *keep)
+{
+  StreamedTexture *victim = nullptr;
+  unsigned long long oldest = m_Frame;
+  bool victimLoading = true;
+
+  for (StreamedTexture *texture : m_Textures)
+  {
+    if (texture == keep || texture->m_ResidentLevel >= texture->m_PinnedLevel) continue;
+
+//    a texture with a load in flight only goes when nothing else can, losing a level throws that load away
+    const unsigned long long lastUsed = texture->m_LevelLastUsed[texture->m_ResidentLevel];
+    const bool loading = texture->m_PendingLevel < texture->m_LevelCount;
+    if (lastUsed < m_Frame && (loading < victimLoading || (loading == victimLoading && lastUsed < oldest)))
+    {
+      oldest = lastUsed;
+      victim = texture;
+      victimLoading = loading;
+    }
+  }
+
+  if (!victim) return false;
+
+  const unsigned long long bytes = victim->GetLevelBytes(victim->m_ResidentLevel);
+  victim->EvictLevel();
+
+  m_ResidentBytes -= bytes;
+  m_Statistics.evictedBytes += bytes;
+  return true;
+}
+
+void TextureStreamer::LoaderLoop()
+{
+  stbi_set_flip_vertically_on_load_thread(1);
+
+  while (true)
+  {
+    LoadRequest request;
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkReady.wait(lock, [this] { return m_Quit || !m_Requests.empty(); });
+      if (m_Quit) return;
+
+      request = m_Requests.front();
+      m_Requests.pop_front();
+    }
+
+    LoadResult result = LoadLevels(request);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Loaded.push_back(std::move(result));
+  }
+}
+
+TextureStreamer::LoadResult TextureStreamer::LoadLevels(const LoadRequest &request) const
+{
+  LoadResult result = { request.texture, request.firstLevel, {} };
+
+  int width, height, bpp;
+  unsigned char *image = stbi_load(request.path.c_str(), &width, &height, &bpp, 4);
+  if (!image) return result;
+
+//  the file changed since the header was read
+  if (width != request.texture->GetWidth() || height != request.texture->GetHeight())
+  {
+    stbi_image_free(image);
+    return result;
+  }
+
+  std::vector<unsigned char> level(image, image + (size_t)width * height * 4);
+  stbi_image_free(image);
+
+//  2x2 box filter down the chain, odd sizes repeat the last row or column
+  for (unsigned int l = 0; l < request.endLevel; l++)
+  {
+    if (l >= request.firstLevel) result.levels.push_back(level);
+    if (l + 1 == request.endLevel) break;
+
+    const int nextWidth = std::max(width / 2, 1);
+    const int nextHeight = std::max(height / 2, 1);
+    std::vector<unsigned char> next((size_t)nextWidth * nextHeight * 4);
+
+    for (int y = 0; y < nextHeight; y++)
+    {
+      const int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+      for (int x = 0; x < nextWidth; x++)
+      {
+        const int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+        for (int c = 0; c < 4; c++)
+        {
+          const int sum = level[(y0 * width + x0) * 4 + c] + level[(y0 * width + x1) * 4 + c] +
+                          level[(y1 * width + x0) * 4 + c] + level[(y1 * width + x1) * 4 + c];
+          next[(y * nextWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+        }
+      }
+    }
+
+    level.swap(next);
+    width = nextWidth;
+    height = nextHeight;
+  }
+
+  return result;
+}
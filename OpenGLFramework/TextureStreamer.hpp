@@ -0,0 +1,143 @@
+//
+//  TextureStreamer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef TextureStreamer_hpp
+#define TextureStreamer_hpp
+
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "StreamedTexture.hpp"
+#include "PoolAllocator.hpp"
+
+struct TextureStreamerStatistics
+{
+  unsigned int textures = 0;
+  unsigned int fullyResident = 0;       // textures with level 0 on the GPU
+  unsigned int pendingLoads = 0;        // queued, loading or waiting to be uploaded
+
+  unsigned long long residentBytes = 0;
+  unsigned long long budgetBytes = 0;
+  unsigned long long wantedBytes = 0;   // what it would take to give every texture used this frame the level it asked for
+
+  unsigned long long uploadedBytes = 0;   // this frame
+  unsigned long long evictedBytes = 0;    // this frame
+  unsigned long long totalUploadedBytes = 0;
+  unsigned long long totalEvictedBytes = 0;
+  unsigned long long totalDiscardedBytes = 0;   // loaded but thrown away, the texture or the budget moved on before the upload
+
+  double uploadMegabytesPerSecond = 0.0;  // averaged over the last second
+
+  float GetBudgetUsage() const { return budgetBytes ? (float)residentBytes / budgetBytes : 0.0f; }
+};
+
+/**
+ * streams the mip levels of StreamedTextures in and out of VRAM
+ *
+ * textures start with only the levels up to pinnedSize pixels, the draws call RecordUse and Update
+ * asks a loader thread for the finer levels that are wanted. when the resident levels go over the
+ * budget the finest level that was needed the longest time ago is dropped first
+ *
+ *   StreamedTexture &texture = streamer.Load("res/textures/wall.png");
+ *   ...
+ *   texture.RecordUse(screenSize);
+ *   texture.Bind();
+ *   renderer.Draw(...);
+ *   ...
+ *   streamer.Update();  // once a frame on the GL thread
+ *
+ * the source files are plain images so a finer level is made by decoding the file again and
+ * box filtering down to it on the loader thread
+ */
+class TextureStreamer
+{
+private:
+  struct LoadRequest
+  {
+    StreamedTexture *texture;
+    std::string path;
+    unsigned int firstLevel;    // finest level wanted
+    unsigned int endLevel;      // one past the coarsest, what was resident when it was asked for
+  };
+
+  struct LoadResult
+  {
+    StreamedTexture *texture;
+    unsigned int firstLevel;
+    std::vector<std::vector<unsigned char>> levels;   // levels[i] is level firstLevel + i
+  };
+
+  ObjectPool<StreamedTexture> m_TexturePool;
+  std::vector<StreamedTexture*> m_Textures;
+
+  unsigned long long m_Budget;
+  unsigned long long m_UploadLimit;   // bytes per frame
+  unsigned int m_PinnedSize;
+  unsigned long long m_Frame;
+  unsigned long long m_ResidentBytes;
+  unsigned long long m_PendingBytes;  // set aside for loads in flight, so two frames dont promise the same budget
+
+//  loader thread
+  std::thread m_Loader;
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkReady;
+  std::deque<LoadRequest> m_Requests;
+  std::deque<LoadResult> m_Loaded;
+  bool m_Quit;
+
+//  loaded but not uploaded yet, only touched on the GL thread
+  std::deque<LoadResult> m_Uploads;
+
+  TextureStreamerStatistics m_Statistics;
+  std::chrono::high_resolution_clock::time_point m_BandwidthStart;
+  unsigned long long m_BandwidthBytes;
+
+public:
+  /**
+   * budgetBytes is for all the resident levels together
+   * uploadBytesPerFrame caps the glTexImage2D traffic so a burst of loads doesnt stall one frame
+   * levels up to pinnedSize pixels are loaded straight away and never evicted
+   */
+  TextureStreamer(unsigned long long budgetBytes, unsigned long long uploadBytesPerFrame = 16 * 1024 * 1024, unsigned int pinnedSize = 64);
+  ~TextureStreamer();
+
+  /**
+   * only reads the image header, the pixels come in later
+   * the texture lives as long as the streamer
+   */
+  StreamedTexture& Load(const std::string &path);
+
+  /**
+   * uploads what the loader finished, evicts down to the budget and requests the levels the draws asked for
+   */
+  void Update();
+
+  inline void SetBudget(unsigned long long budgetBytes) { m_Budget = budgetBytes; }
+  inline unsigned long long GetBudget() const { return m_Budget; }
+  inline const TextureStreamerStatistics& GetStatistics() const { return m_Statistics; }
+
+private:
+  void LoaderLoop();
+  LoadResult LoadLevels(const LoadRequest &request) const;
+
+  void UploadLoaded();
+  void RequestWanted();
+
+  /**
+   * evicts the least recently needed level of any texture other than keep, false if nothing can go
+   * levels needed this frame are never evicted, textures with a load in flight go last
+   */
+  bool EvictOne(const StreamedTexture *keep);
+};
+
+#endif /* TextureStreamer_hpp */
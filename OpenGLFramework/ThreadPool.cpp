@@ -0,0 +1,113 @@
+//
+//  ThreadPool.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+: m_Count(0), m_ChunkSize(1), m_NextChunk(0), m_ActiveWorkers(0), m_Generation(0), m_Quit(false)
+{
+  if (threadCount == 0)
+  {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  
+//  the calling thread is the last worker
+  for (unsigned int i = 0; i + 1 < threadCount; i++)
+  {
+    m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Quit = true;
+  }
+  m_WorkReady.notify_all();
+  
+  for (auto &worker : m_Workers)
+  {
+    worker.join();
+  }
+}
+
+ThreadPool& ThreadPool::Get()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+void ThreadPool::ParallelFor(unsigned int count, unsigned int minChunkSize, const std::function<void(unsigned int, unsigned int)> &job)
+{
+  if (count == 0) return;
+  
+  const unsigned int threads = GetThreadCount();
+  
+  if (threads == 1 || count <= minChunkSize)
+  {
+    job(0, count);
+    return;
+  }
+  
+//  a few chunks per thread so a slow thread doesnt hold everyone up
+  const unsigned int chunkSize = std::max(minChunkSize, (count + threads * 4 - 1) / (threads * 4));
+  
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Job = job;
+    m_Count = count;
+    m_ChunkSize = chunkSize;
+    m_NextChunk = 0;
+    m_ActiveWorkers = (unsigned int)m_Workers.size();
+    m_Generation++;
+  }
+  m_WorkReady.notify_all();
+  
+  RunChunks();
+  
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_WorkDone.wait(lock, [this] { return m_ActiveWorkers == 0; });
+  m_Job = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+  unsigned int generation = 0;
+  
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkReady.wait(lock, [&] { return m_Quit || m_Generation != generation; });
+      
+      if (m_Quit) return;
+      generation = m_Generation;
+    }
+    
+    RunChunks();
+    
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_ActiveWorkers--;
+    }
+    m_WorkDone.notify_one();
+  }
+}
+
+void ThreadPool::RunChunks()
+{
+  while (true)
+  {
+    unsigned int begin = m_NextChunk.fetch_add(m_ChunkSize);
+    if (begin >= m_Count) return;
+    
+    m_Job(begin, std::min(begin + m_ChunkSize, m_Count));
+  }
+}
@@ -0,0 +1,66 @@
+//
+//  ThreadPool.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * a fixed set of worker threads that split a range of work between them
+ * the calling thread works on the range too and ParallelFor only returns once everything is done
+ */
+class ThreadPool
+{
+private:
+  std::vector<std::thread> m_Workers;
+  
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkReady;
+  std::condition_variable m_WorkDone;
+  
+//  the job that is currently running
+  std::function<void(unsigned int, unsigned int)> m_Job;
+  unsigned int m_Count;
+  unsigned int m_ChunkSize;
+  std::atomic<unsigned int> m_NextChunk;
+  unsigned int m_ActiveWorkers;
+  unsigned int m_Generation;    // bumped for every job so the workers know there is new work
+  bool m_Quit;
+  
+public:
+  /**
+   * threadCount = 0 uses every core, the calling thread counts as one of them
+   */
+  ThreadPool(unsigned int threadCount = 0);
+  ~ThreadPool();
+  
+  /**
+   * calls job(begin, end) over [0, count) in chunks of at least minChunkSize
+   * small ranges run on the calling thread only
+   */
+  void ParallelFor(unsigned int count, unsigned int minChunkSize, const std::function<void(unsigned int, unsigned int)> &job);
+  
+  inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size() + 1; }
+  
+  /**
+   * shared pool so the subsystems dont each spin up their own threads
+   */
+  static ThreadPool& Get();
+  
+private:
+  void WorkerLoop();
+  void RunChunks();
+};
+
+#endif /* ThreadPool_hpp */
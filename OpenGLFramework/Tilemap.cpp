@@ -0,0 +1,142 @@
+//
+//  Tilemap.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "Tilemap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+TileAtlas::TileAtlas(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight)
+: m_Columns(std::max(width / tileWidth, 1u)), m_Rows(std::max(height / tileHeight, 1u))
+{
+  const float texelU = 1.0f / width;
+  const float texelV = 1.0f / height;
+
+  m_UVs.reserve(m_Columns * m_Rows);
+  for (unsigned int row = 0; row < m_Rows; row++)
+  {
+    for (unsigned int column = 0; column < m_Columns; column++)
+    {
+//      textures are loaded flipped so v = 1 is the top row of the image
+      const float u0 = (float)(column * tileWidth) / width;
+      const float u1 = (float)((column + 1) * tileWidth) / width;
+      const float v1 = 1.0f - (float)(row * tileHeight) / height;
+      const float v0 = 1.0f - (float)((row + 1) * tileHeight) / height;
+
+      m_UVs.push_back(glm::vec4(u0 + texelU * 0.5f, v0 + texelV * 0.5f, u1 - texelU * 0.5f, v1 - texelV * 0.5f));
+    }
+  }
+}
+
+const unsigned int Tilemap::FloatsPerVertex;
+const unsigned int Tilemap::VerticesPerTile;
+const unsigned int Tilemap::IndicesPerTile;
+
+Tilemap::Tilemap(unsigned int width, unsigned int height, const TileAtlas &atlas, unsigned int chunkSize, float tileSize)
+: m_Width(width), m_Height(height), m_ChunkSize(chunkSize),
+  m_ChunksX((width + chunkSize - 1) / chunkSize), m_ChunksY((height + chunkSize - 1) / chunkSize),
+  m_TileSize(tileSize), m_Atlas(atlas)
+{
+  m_Tiles.resize((size_t)width * height, 0);
+  m_ChunkVersions.resize(m_ChunksX * m_ChunksY, 0);
+  m_RowVersions.resize(m_ChunksX * m_ChunksY * chunkSize, 0);
+  m_ChunkTileCounts.resize(m_ChunksX * m_ChunksY, 0);
+}
+
+void Tilemap::SetTile(unsigned int x, unsigned int y, unsigned short tile)
+{
+  unsigned short &current = m_Tiles[(size_t)y * m_Width + x];
+  if (current == tile) return;
+
+  const unsigned int chunk = (y / m_ChunkSize) * m_ChunksX + x / m_ChunkSize;
+  const unsigned int atlasTiles = m_Atlas.GetTileCount();
+
+//  empty and past the end of the atlas both draw nothing
+  m_ChunkTileCounts[chunk] += (tile - 1u < atlasTiles) - (current - 1u < atlasTiles);
+
+  current = tile;
+  m_ChunkVersions[chunk]++;
+  m_RowVersions[chunk * m_ChunkSize + y % m_ChunkSize]++;
+}
+
+void Tilemap::GetVisibleChunks(const glm::mat4 &viewProjection, std::vector<unsigned int> &chunks) const
+{
+  chunks.clear();
+
+//  an orthographic camera is affine so the z = 0 plane maps to NDC through a 2x2 matrix and an offset,
+//  take the NDC corners back through its inverse and bound them in world space
+  const float a = viewProjection[0][0], b = viewProjection[1][0];
+  const float c = viewProjection[0][1], d = viewProjection[1][1];
+  const float determinant = a * d - b * c;
+  if (std::fabs(determinant) < 1e-12f) return;
+
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+  for (int corner = 0; corner < 4; corner++)
+  {
+    const float x = (corner & 1 ? 1.0f : -1.0f) - viewProjection[3][0];
+    const float y = (corner & 2 ? 1.0f : -1.0f) - viewProjection[3][1];
+
+    const float worldX = (d * x - b * y) / determinant;
+    const float worldY = (a * y - c * x) / determinant;
+
+    minX = std::min(minX, worldX);
+    maxX = std::max(maxX, worldX);
+    minY = std::min(minY, worldY);
+    maxY = std::max(maxY, worldY);
+  }
+
+  const float chunkWorld = m_ChunkSize * m_TileSize;
+  if (maxX < 0.0f || maxY < 0.0f || minX >= m_Width * m_TileSize || minY >= m_Height * m_TileSize) return;
+
+//  clamped as floats first so a huge view cant overflow the cast
+  const unsigned int beginX = (unsigned int)std::max(std::floor(minX / chunkWorld), 0.0f);
+  const unsigned int beginY = (unsigned int)std::max(std::floor(minY / chunkWorld), 0.0f);
+  const unsigned int endX = (unsigned int)std::min(std::floor(maxX / chunkWorld), (float)m_ChunksX - 1.0f) + 1;
+  const unsigned int endY = (unsigned int)std::min(std::floor(maxY / chunkWorld), (float)m_ChunksY - 1.0f) + 1;
+
+  for (unsigned int y = beginY; y < endY; y++)
+  {
+    for (unsigned int x = beginX; x < endX; x++)
+    {
+      chunks.push_back(y * m_ChunksX + x);
+    }
+  }
+}
+
+void Tilemap::BuildRows(unsigned int chunk, unsigned int firstRow, unsigned int rowCount, float *vertices) const
+{
+  const unsigned int beginX = (chunk % m_ChunksX) * m_ChunkSize;
+  const unsigned int beginY = (chunk / m_ChunksX) * m_ChunkSize;
+  const unsigned int atlasTiles = m_Atlas.GetTileCount();
+
+  float *v = vertices;
+  for (unsigned int row = firstRow; row < firstRow + rowCount; row++)
+  {
+    const unsigned int y = beginY + row;
+    const float y0 = y * m_TileSize, y1 = (y + 1) * m_TileSize;
+
+    for (unsigned int x = beginX; x < beginX + m_ChunkSize; x++, v += VerticesPerTile * FloatsPerVertex)
+    {
+//      empty, past the end of the atlas or off the edge of the map
+      const unsigned int index = x < m_Width && y < m_Height ? m_Tiles[(size_t)y * m_Width + x] - 1u : ~0u;
+      if (index >= atlasTiles)
+      {
+        std::fill(v, v + VerticesPerTile * FloatsPerVertex, 0.0f);
+        continue;
+      }
+
+      const glm::vec4 &uv = m_Atlas.GetUV(index);
+      const float x0 = x * m_TileSize, x1 = (x + 1) * m_TileSize;
+
+//      same winding as the other quads, drawn with 0 1 2 2 3 0
+      v[0]  = x0; v[1]  = y0; v[2]  = uv.x; v[3]  = uv.y;
+      v[4]  = x1; v[5]  = y0; v[6]  = uv.z; v[7]  = uv.y;
+      v[8]  = x1; v[9]  = y1; v[10] = uv.z; v[11] = uv.w;
+      v[12] = x0; v[13] = y1; v[14] = uv.x; v[15] = uv.w;
+    }
+  }
+}
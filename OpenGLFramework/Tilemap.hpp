@@ -0,0 +1,107 @@
+//
+//  Tilemap.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef Tilemap_hpp
+#define Tilemap_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+/**
+ * a texture split into a grid of equal tiles, index 0 is the top left one and they go across then down
+ * the uvs are worked out once so a lookup is just an index into a table
+ */
+class TileAtlas
+{
+private:
+  unsigned int m_Columns;
+  unsigned int m_Rows;
+  std::vector<glm::vec4> m_UVs;   // u0, v0, u1, v1
+
+public:
+  /**
+   * width and height of the texture and the tile in pixels
+   * the uvs are pulled in by half a texel so linear filtering doesnt bleed in the neighbouring tiles
+   */
+  TileAtlas(unsigned int width, unsigned int height, unsigned int tileWidth, unsigned int tileHeight);
+
+  inline const glm::vec4& GetUV(unsigned int index) const { return m_UVs[index]; }
+  inline unsigned int GetTileCount() const { return (unsigned int)m_UVs.size(); }
+  inline unsigned int GetColumns() const { return m_Columns; }
+  inline unsigned int GetRows() const { return m_Rows; }
+};
+
+/**
+ * a grid of tiles split into square chunks, the data side of the tilemap renderer
+ *
+ * a tile is 0 when it is empty, otherwise it is 1 + its index in the atlas. every chunk and every row
+ * of a chunk has a version that goes up when one of its tiles changes, so whoever baked a chunk can
+ * tell which rows are out of date without the map having to know about them
+ *
+ * tile (x, y) covers x * tileSize to (x + 1) * tileSize in world space, y up, at z = 0
+ */
+class Tilemap
+{
+public:
+  static const unsigned int FloatsPerVertex = 4;    // x, y, u, v
+  static const unsigned int VerticesPerTile = 4;
+  static const unsigned int IndicesPerTile = 6;
+
+private:
+  unsigned int m_Width;         // in tiles
+  unsigned int m_Height;
+  unsigned int m_ChunkSize;     // tiles along a side
+  unsigned int m_ChunksX;
+  unsigned int m_ChunksY;
+  float m_TileSize;             // in world units
+
+  std::vector<unsigned short> m_Tiles;
+  std::vector<unsigned int> m_ChunkVersions;
+  std::vector<unsigned int> m_RowVersions;      // chunkSize per chunk
+  std::vector<unsigned int> m_ChunkTileCounts;  // tiles with something to draw
+
+  TileAtlas m_Atlas;
+
+public:
+  Tilemap(unsigned int width, unsigned int height, const TileAtlas &atlas, unsigned int chunkSize = 32, float tileSize = 1.0f);
+
+  /**
+   * only bumps the versions if the tile actually changes
+   */
+  void SetTile(unsigned int x, unsigned int y, unsigned short tile);
+  inline unsigned short GetTile(unsigned int x, unsigned int y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+
+  /**
+   * chunks overlapping what viewProjection shows, viewProjection is glm::ortho times the view
+   * chunks is cleared first, they come out row by row
+   */
+  void GetVisibleChunks(const glm::mat4 &viewProjection, std::vector<unsigned int> &chunks) const;
+
+  /**
+   * writes rowCount rows of the chunk starting at firstRow, chunkSize quads a row
+   * every tile keeps the same place in the chunk so a row can be written again on its own,
+   * empty tiles and the ones past the edge of the map get a quad with no area
+   * vertices needs room for rowCount * chunkSize * VerticesPerTile * FloatsPerVertex floats
+   */
+  void BuildRows(unsigned int chunk, unsigned int firstRow, unsigned int rowCount, float *vertices) const;
+
+  inline unsigned int GetChunkVersion(unsigned int chunk) const { return m_ChunkVersions[chunk]; }
+  inline unsigned int GetRowVersion(unsigned int chunk, unsigned int row) const { return m_RowVersions[chunk * m_ChunkSize + row]; }
+  inline unsigned int GetChunkTileCount(unsigned int chunk) const { return m_ChunkTileCounts[chunk]; }
+  inline unsigned int GetChunkCount() const { return m_ChunksX * m_ChunksY; }
+  inline unsigned int GetMaxChunkTiles() const { return m_ChunkSize * m_ChunkSize; }
+
+  inline unsigned int GetWidth() const { return m_Width; }
+  inline unsigned int GetHeight() const { return m_Height; }
+  inline unsigned int GetChunkSize() const { return m_ChunkSize; }
+  inline float GetTileSize() const { return m_TileSize; }
+  inline const TileAtlas& GetAtlas() const { return m_Atlas; }
+};
+
+#endif /* Tilemap_hpp */
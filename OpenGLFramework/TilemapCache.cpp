@@ -0,0 +1,133 @@
+//
+//  TilemapCache.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "TilemapCache.hpp"
+
+TilemapCache::TilemapCache(const Tilemap &tilemap, unsigned int slotCount)
+: m_Tilemap(tilemap), m_SlotTiles(tilemap.GetMaxChunkTiles()), m_Frame(0)
+{
+  m_Slots.resize(slotCount);
+  m_SlotRowVersions.resize(slotCount * tilemap.GetChunkSize(), 0);
+  m_ChunkSlots.resize(tilemap.GetChunkCount(), -1);
+
+//  handed out from the back so slot 0 goes first
+  for (unsigned int i = slotCount; i > 0; i--)
+  {
+    m_FreeSlots.push_back(i - 1);
+  }
+}
+
+void TilemapCache::Update(const glm::mat4 &viewProjection)
+{
+  m_Frame++;
+  m_Statistics = TilemapStatistics();
+  m_Staging.clear();
+  m_Uploads.clear();
+  m_Draws.clear();
+
+  m_Tilemap.GetVisibleChunks(viewProjection, m_Visible);
+  m_Statistics.visibleChunks = (unsigned int)m_Visible.size();
+
+  const unsigned int chunkSize = m_Tilemap.GetChunkSize();
+
+  for (unsigned int chunk : m_Visible)
+  {
+    int slot = m_ChunkSlots[chunk];
+    if (slot < 0)
+    {
+      slot = AcquireSlot();
+      if (slot < 0)
+      {
+        m_Statistics.droppedChunks++;
+        continue;
+      }
+
+      m_ChunkSlots[chunk] = slot;
+      m_Slots[slot].chunk = chunk;
+
+      Bake(slot, chunk, 0, chunkSize);
+      m_Statistics.bakedChunks++;
+    }
+    else if (m_Slots[slot].version != m_Tilemap.GetChunkVersion(chunk))
+    {
+//      runs of rows that moved since the bake
+      const unsigned int *baked = &m_SlotRowVersions[slot * chunkSize];
+      for (unsigned int row = 0; row < chunkSize;)
+      {
+        if (baked[row] == m_Tilemap.GetRowVersion(chunk, row))
+        {
+          row++;
+          continue;
+        }
+
+        unsigned int end = row + 1;
+        while (end < chunkSize && baked[end] != m_Tilemap.GetRowVersion(chunk, end)) end++;
+
+        Bake(slot, chunk, row, end - row);
+        m_Statistics.rebuiltRows += end - row;
+        row = end;
+      }
+    }
+
+    Slot &resident = m_Slots[slot];
+    resident.version = m_Tilemap.GetChunkVersion(chunk);
+    resident.lastUsed = m_Frame;
+
+    const unsigned int tiles = m_Tilemap.GetChunkTileCount(chunk);
+    if (tiles == 0) continue;
+
+    m_Draws.push_back({ slot * m_SlotTiles * Tilemap::VerticesPerTile, m_SlotTiles * Tilemap::IndicesPerTile });
+    m_Statistics.drawCalls++;
+    m_Statistics.tiles += tiles;
+  }
+}
+
+int TilemapCache::AcquireSlot()
+{
+  if (!m_FreeSlots.empty())
+  {
+    const unsigned int slot = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+    return slot;
+  }
+
+  int oldest = -1;
+  for (unsigned int i = 0; i < m_Slots.size(); i++)
+  {
+    if (m_Slots[i].lastUsed == m_Frame) continue;
+    if (oldest < 0 || m_Slots[i].lastUsed < m_Slots[oldest].lastUsed) oldest = i;
+  }
+
+  if (oldest >= 0)
+  {
+    m_ChunkSlots[m_Slots[oldest].chunk] = -1;
+    m_Statistics.evictedChunks++;
+  }
+  return oldest;
+}
+
+void TilemapCache::Bake(unsigned int slot, unsigned int chunk, unsigned int firstRow, unsigned int rowCount)
+{
+  const unsigned int chunkSize = m_Tilemap.GetChunkSize();
+  const unsigned int tileFloats = Tilemap::VerticesPerTile * Tilemap::FloatsPerVertex;
+  const unsigned int floats = rowCount * chunkSize * tileFloats;
+
+  const unsigned int staging = (unsigned int)m_Staging.size();
+  m_Staging.resize(staging + floats);
+  m_Tilemap.BuildRows(chunk, firstRow, rowCount, &m_Staging[staging]);
+
+  const unsigned int offset = (slot * m_SlotTiles + firstRow * chunkSize) * tileFloats * sizeof(float);
+  m_Uploads.push_back({ offset, floats * (unsigned int)sizeof(float), staging });
+
+  for (unsigned int row = firstRow; row < firstRow + rowCount; row++)
+  {
+    m_SlotRowVersions[slot * chunkSize + row] = m_Tilemap.GetRowVersion(chunk, row);
+  }
+
+  m_Statistics.uploads++;
+  m_Statistics.uploadedBytes += floats * sizeof(float);
+}
@@ -0,0 +1,110 @@
+//
+//  TilemapCache.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef TilemapCache_hpp
+#define TilemapCache_hpp
+
+#include <stdio.h>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "Tilemap.hpp"
+
+struct TilemapStatistics
+{
+  unsigned int visibleChunks = 0;
+  unsigned int drawCalls = 0;
+  unsigned int tiles = 0;
+  unsigned int bakedChunks = 0;       // came on screen without a slot and were baked whole
+  unsigned int rebuiltRows = 0;       // edited rows baked again in chunks that kept their slot
+  unsigned int evictedChunks = 0;     // lost their slot to a chunk that came on screen
+  unsigned int droppedChunks = 0;     // visible but every slot was already drawn this frame, make the pool bigger
+  unsigned int uploads = 0;
+  unsigned long long uploadedBytes = 0;
+};
+
+/**
+ * a byte range of the slot buffer to overwrite with floats from GetStaging()
+ */
+struct TilemapUpload
+{
+  unsigned int offset;    // bytes into the vertex buffer
+  unsigned int size;      // bytes
+  unsigned int staging;   // first float in the staging
+};
+
+struct TilemapDraw
+{
+  unsigned int baseVertex;
+  unsigned int indexCount;
+};
+
+/**
+ * decides what the tilemap renderer uploads and draws every frame, no OpenGL in here
+ *
+ * the vertex buffer is a pool of slots holding one chunk each. a visible chunk without a slot takes a
+ * free one or the one drawn the longest time ago and is baked whole. a chunk that kept its slot only has
+ * the rows whose version moved baked again, runs of them go up as one upload
+ * so a frame with no edits and no new chunks on screen uploads nothing
+ */
+class TilemapCache
+{
+private:
+  struct Slot
+  {
+    int chunk = -1;
+    unsigned int version = 0;
+    unsigned long long lastUsed = 0;
+  };
+
+  const Tilemap &m_Tilemap;
+  unsigned int m_SlotTiles;
+
+  std::vector<Slot> m_Slots;
+  std::vector<unsigned int> m_SlotRowVersions;    // chunkSize per slot, the row versions it was baked from
+  std::vector<int> m_ChunkSlots;                  // slot of every chunk in the map, -1 when it has none
+  std::vector<unsigned int> m_FreeSlots;
+
+  std::vector<unsigned int> m_Visible;
+  std::vector<float> m_Staging;
+  std::vector<TilemapUpload> m_Uploads;
+  std::vector<TilemapDraw> m_Draws;
+
+  unsigned long long m_Frame;
+  TilemapStatistics m_Statistics;
+
+public:
+  /**
+   * the tilemap has to outlive the cache, slotCount is how many chunks can be on the GPU at once
+   */
+  TilemapCache(const Tilemap &tilemap, unsigned int slotCount = 256);
+
+  /**
+   * works out this frames uploads and draws, they stay valid until the next Update
+   */
+  void Update(const glm::mat4 &viewProjection);
+
+  inline const std::vector<TilemapUpload>& GetUploads() const { return m_Uploads; }
+  inline const std::vector<TilemapDraw>& GetDraws() const { return m_Draws; }
+  inline const float* GetStaging() const { return m_Staging.data(); }
+  inline const TilemapStatistics& GetStatistics() const { return m_Statistics; }
+
+  inline unsigned int GetSlotCount() const { return (unsigned int)m_Slots.size(); }
+  inline unsigned int GetSlotTiles() const { return m_SlotTiles; }
+  inline unsigned int GetSlotBytes() const { return m_SlotTiles * Tilemap::VerticesPerTile * Tilemap::FloatsPerVertex * sizeof(float); }
+
+private:
+  /**
+   * a free slot or the least recently drawn one, -1 if all of them were drawn this frame
+   */
+  int AcquireSlot();
+
+  void Bake(unsigned int slot, unsigned int chunk, unsigned int firstRow, unsigned int rowCount);
+};
+
+#endif /* TilemapCache_hpp */
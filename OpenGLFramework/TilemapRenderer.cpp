@@ -0,0 +1,56 @@
+//
+//  TilemapRenderer.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "TilemapRenderer.hpp"
+#include "Renderer.h"
+#include "VertexBufferLayout.hpp"
+
+#include <vector>
+
+/**
+ * 0 1 2 2 3 0 for every quad of a full chunk
+ */
+static std::vector<unsigned int> MakeQuadIndices(unsigned int quads)
+{
+  std::vector<unsigned int> indices(quads * Tilemap::IndicesPerTile);
+  for (unsigned int i = 0; i < quads; i++)
+  {
+    const unsigned int v = i * Tilemap::VerticesPerTile;
+    unsigned int *index = &indices[i * Tilemap::IndicesPerTile];
+    index[0] = v; index[1] = v + 1; index[2] = v + 2;
+    index[3] = v + 2; index[4] = v + 3; index[5] = v;
+  }
+  return indices;
+}
+
+TilemapRenderer::TilemapRenderer(const Tilemap &tilemap, unsigned int slotCount)
+: m_Cache(tilemap, slotCount),
+  m_VertexBuffer(nullptr, slotCount * m_Cache.GetSlotBytes()),
+  m_IndexBuffer(MakeQuadIndices(m_Cache.GetSlotTiles()).data(), m_Cache.GetSlotTiles() * Tilemap::IndicesPerTile)
+{
+  static_assert(Layout<Float2, Float2>::Stride == Tilemap::FloatsPerVertex * sizeof(float), "layout has to match Tilemap::BuildRows");
+  m_VertexArray.AddBuffer(m_VertexBuffer, Layout<Float2, Float2>());
+  m_VertexArray.Unbind();
+}
+
+void TilemapRenderer::Draw(const Renderer &renderer, Shader &shader, const glm::mat4 &viewProjection)
+{
+  m_Cache.Update(viewProjection);
+
+  for (const TilemapUpload &upload : m_Cache.GetUploads())
+  {
+    m_VertexBuffer.SetSubData(m_Cache.GetStaging() + upload.staging, upload.size, upload.offset);
+  }
+
+  shader.Bind();
+  shader.SetUniformMat4f("u_MVP", viewProjection);
+
+  for (const TilemapDraw &draw : m_Cache.GetDraws())
+  {
+    renderer.DrawRange(m_VertexArray, m_IndexBuffer, shader, draw.indexCount, 0, draw.baseVertex);
+  }
+}
@@ -0,0 +1,60 @@
+//
+//  TilemapRenderer.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef TilemapRenderer_hpp
+#define TilemapRenderer_hpp
+
+#include <stdio.h>
+
+#include "glm/glm.hpp"
+
+#include "TilemapCache.hpp"
+#include "VertexArray.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+
+class Renderer;
+class Shader;
+
+/**
+ * GL side of the tilemap, every visible chunk is one draw out of its own slot of a static vertex buffer
+ * the slots share one index buffer of quads and are picked with the base vertex, TilemapCache decides
+ * which slots are baked and which rows go up again
+ *
+ *   Tilemap map(4096, 4096, TileAtlas(atlasWidth, atlasHeight, 16, 16));
+ *   TilemapRenderer tilemapRenderer(map);
+ *   ...
+ *   map.SetTile(x, y, tile);
+ *   atlasTexture.Bind();
+ *   tilemapRenderer.Draw(renderer, shader, glm::ortho(...) * view);
+ *
+ * works with res/shaders/Basic.shader, u_Texture has to be set to the slot the atlas is bound to
+ */
+class TilemapRenderer
+{
+private:
+  TilemapCache m_Cache;
+
+  VertexBuffer m_VertexBuffer;
+  IndexBuffer m_IndexBuffer;
+  VertexArray m_VertexArray;
+
+public:
+  /**
+   * the tilemap has to outlive the renderer, slotCount is how many chunks can be on the GPU at once
+   */
+  TilemapRenderer(const Tilemap &tilemap, unsigned int slotCount = 256);
+
+  /**
+   * uploads what is out of date, sets u_MVP and draws every visible chunk
+   */
+  void Draw(const Renderer &renderer, Shader &shader, const glm::mat4 &viewProjection);
+
+  inline const TilemapStatistics& GetStatistics() const { return m_Cache.GetStatistics(); }
+};
+
+#endif /* TilemapRenderer_hpp */
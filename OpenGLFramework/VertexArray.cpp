@@ -11,6 +11,7 @@
 #include "VertexBufferLayout.hpp"
 
 VertexArray::VertexArray()
+: m_AttribCount(0)
 {
   GLCall(glGenVertexArrays(1, &m_RendererID));
 };
@@ -22,26 +23,64 @@ VertexArray::~VertexArray()
 };
 
 void VertexArray::AddBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout)
+{
+  const auto& elements = layout.GetElements();
+  AddAttributes(vb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), 0, m_AttribCount);
+}
+
+void VertexArray::AddBuffer(const VertexBuffer &vb, const VertexLayoutInfo &layout)
+{
+  AddAttributes(vb, layout.elements, layout.count, layout.stride, 0, m_AttribCount);
+}
+
+void VertexArray::AddInstanceBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout)
+{
+  const auto& elements = layout.GetElements();
+  AddAttributes(vb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), 1, m_AttribCount);
+}
+
+void VertexArray::AddInstanceBuffer(const VertexBuffer &vb, const VertexLayoutInfo &layout)
+{
+  AddAttributes(vb, layout.elements, layout.count, layout.stride, 1, m_AttribCount);
+}
+
+void VertexArray::AddInstanceBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout, unsigned int firstIndex)
+{
+  const auto& elements = layout.GetElements();
+  AddAttributes(vb, elements.data(), (unsigned int)elements.size(), layout.GetStride(), 1, firstIndex);
+}
+
+void VertexArray::AddAttributes(const VertexBuffer &vb, const VertexBufferElement *elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int firstIndex)
 {
   Bind(); // bind the vertex array
   
   vb.Bind();  // bind the buffer
   
-  const auto& elements = layout.GetElements();
-  
   unsigned int offset = 0;
   
-  for (unsigned int i = 0; i < elements.size(); i++)
+  for (unsigned int i = 0; i < count; i++)
   {
     const auto& element = elements[i];
+    const unsigned int index = firstIndex + i;
     
     //  we need to enable the vertex attribute with the index you want to enable
-    GLCall(glEnableVertexAttribArray(i));
+    GLCall(glEnableVertexAttribArray(index));
     //  specify the attribute for hte first vertex whihc is at index 0, last 0 is 0 bytes
-    GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
+    if (element.type == GL_UNSIGNED_INT && !element.normalized)
+    {
+//      integer attributes have to go through the I version or they get converted to floats
+      GLCall(glVertexAttribIPointer(index, element.count, element.type, stride, (const void*)offset));
+    }
+    else
+    {
+      GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, stride, (const void*)offset));
+    }
+    GLCall(glVertexAttribDivisor(index, divisor));
     
     offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
   }
+  
+  if (firstIndex + count > m_AttribCount) m_AttribCount = firstIndex + count;
 }
 
 void VertexArray::Bind() const
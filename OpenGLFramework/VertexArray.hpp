@@ -13,6 +13,8 @@
 #include "VertexBuffer.hpp"
 
 class VertexBufferLayout;
+struct VertexBufferElement;
+struct VertexLayoutInfo;
 
 /**
  *
@@ -20,6 +22,7 @@ class VertexBufferLayout;
 class VertexArray {
 private:
   unsigned int m_RendererID;
+  unsigned int m_AttribCount;   // next free attribute index, so buffers added later dont overwrite earlier ones
   
 public:
   VertexArray();
@@ -27,9 +30,30 @@ public:
   
   void AddBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout);
   
+  /**
+   * for compile time layouts - va.AddBuffer(vb, Layout<Float2, Float2>())
+   */
+  void AddBuffer(const VertexBuffer &vb, const VertexLayoutInfo &layout);
+  
+  /**
+   * same as AddBuffer but the attributes advance once per instance instead of once per vertex
+   */
+  void AddInstanceBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout);
+  void AddInstanceBuffer(const VertexBuffer &vb, const VertexLayoutInfo &layout);
+  
+  /**
+   * instanced attributes starting at a fixed location, for shaders that declare layout(location = n)
+   * adding a buffer at the same location again replaces the previous one
+   */
+  void AddInstanceBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout, unsigned int firstIndex);
+  
   void Bind() const;
   void Unbind() const;
   
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+  
+private:
+  void AddAttributes(const VertexBuffer &vb, const VertexBufferElement *elements, unsigned int count, unsigned int stride, unsigned int divisor, unsigned int firstIndex);
 };
 
 
@@ -9,6 +9,7 @@
 #include "Renderer.h"
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+: m_Size(size)
 {
   GLCall(glGenBuffers(1, &m_RendererID)); // gives us back an id
 //  select that bufffer
@@ -18,11 +19,38 @@ VertexBuffer::VertexBuffer(const void* data, unsigned int size)
   GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+: m_Size(size)
+{
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+//  no data yet, stream draw tells the driver we rewrite it every frame
+  GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+}
+
 VertexBuffer::~VertexBuffer()
 {
   GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+  ASSERT(size <= m_Size);
+  
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+//  orphan the old storage then fill the new one
+  GLCall(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_STREAM_DRAW));
+  GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+}
+
+void VertexBuffer::SetSubData(const void* data, unsigned int size, unsigned int offset)
+{
+  ASSERT(offset + size <= m_Size);
+  
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 void VertexBuffer::Bind() const
 {
   GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
@@ -18,14 +18,34 @@ class VertexBuffer
 private:
 //  OpenGL needs some numeric to keep track of objects - this is the actual id used by OpenGL
   unsigned int m_RendererID;
+  unsigned int m_Size;      // in bytes
   
 public:
   VertexBuffer(const void* data, unsigned int size);
+  
+  /**
+   * empty buffer meant to be refilled every frame with SetData
+   */
+  VertexBuffer(unsigned int size);
   ~VertexBuffer();
   
+  /**
+   * replaces the contents - the old storage is orphaned first
+   * so we dont stall waiting on draws that still read last frames data
+   */
+  void SetData(const void* data, unsigned int size);
+  
+  /**
+   * overwrites part of the buffer and leaves the rest alone, no orphaning
+   * for buffers split into ranges that are updated one at a time
+   */
+  void SetSubData(const void* data, unsigned int size, unsigned int offset);
+  
   void Bind() const;
   void Unbind() const;
   
+  inline unsigned int GetSize() const { return m_Size; }
+  inline unsigned int GetRendererID() const { return m_RendererID; }
 };
 
 #endif /* VertexBuffer_hpp */
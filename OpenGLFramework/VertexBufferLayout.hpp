@@ -9,6 +9,9 @@
 #define VertexBufferLayout_hpp
 
 #include <stdio.h>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <GL/glew.h>
@@ -21,15 +24,21 @@ struct VertexBufferElement
   unsigned int count;
   unsigned char normalized;
   
+  /**
+   * 0 for types we dont support, usable at compile time
+   */
+  static constexpr unsigned int SizeOfType(unsigned int type)
+  {
+    return type == GL_FLOAT         ? 4 :
+           type == GL_UNSIGNED_INT  ? 4 :
+           type == GL_UNSIGNED_BYTE ? 1 : 0;
+  }
+  
   static unsigned int GetSizeOfType(unsigned int type)
   {
-    switch (type) {
-      case GL_FLOAT:            return 4;
-      case GL_UNSIGNED_INT:     return 4;
-      case GL_UNSIGNED_BYTE:    return 1;
-    }
-    ASSERT(false);
-    return 0;
+    unsigned int size = SizeOfType(type);
+    ASSERT(size != 0);
+    return size;
   }
 };
 
@@ -44,37 +53,154 @@ public:
   :m_Stride(0)
   {};
   
+  /**
+   * only float, unsigned int and unsigned char are supported - see the specialisations below
+   */
   template<typename T>
   void Push(unsigned int count)
   {
-//    static_assert(false);
+    static_assert(sizeof(T) == 0, "VertexBufferLayout::Push only supports float, unsigned int and unsigned char");
   }
   
-  template<>
-  void Push<float>(unsigned int count)
-  {
-    m_Elements.push_back({GL_FLOAT, count, GL_FALSE});
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
-  }
+  inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
   
-  template<>
-  void Push<unsigned int>(unsigned int count)
-  {
-    m_Elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE});
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-  }
+  inline unsigned int GetStride() const { return m_Stride; }
   
-  template<>
-  void Push<unsigned char>(unsigned int count)
+};
+
+// explicit specialisations have to live at namespace scope, GCC rejects them inside the class
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+  m_Elements.push_back({GL_FLOAT, count, GL_FALSE});
+  m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+{
+  m_Elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE});
+  m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+{
+  m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE});
+  m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
+
+
+/*************************** COMPILE TIME LAYOUTS START ***************************/
+
+/**
+ * one attribute of a compile time layout, use the aliases below
+ */
+template<unsigned int Type, unsigned int Count, bool Normalized>
+struct VertexAttribute
+{
+  static_assert(VertexBufferElement::SizeOfType(Type) != 0, "unsupported vertex attribute type");
+  static_assert(Count >= 1 && Count <= 4, "vertex attributes have 1 to 4 components");
+  
+  static constexpr unsigned int type = Type;
+  static constexpr unsigned int count = Count;
+  static constexpr unsigned char normalized = Normalized ? GL_TRUE : GL_FALSE;
+  static constexpr unsigned int size = Count * VertexBufferElement::SizeOfType(Type);
+};
+
+using Float1 = VertexAttribute<GL_FLOAT, 1, false>;
+using Float2 = VertexAttribute<GL_FLOAT, 2, false>;
+using Float3 = VertexAttribute<GL_FLOAT, 3, false>;
+using Float4 = VertexAttribute<GL_FLOAT, 4, false>;
+using UInt1 = VertexAttribute<GL_UNSIGNED_INT, 1, false>;
+using UInt2 = VertexAttribute<GL_UNSIGNED_INT, 2, false>;
+using UInt3 = VertexAttribute<GL_UNSIGNED_INT, 3, false>;
+using UInt4 = VertexAttribute<GL_UNSIGNED_INT, 4, false>;
+using UByte4Norm = VertexAttribute<GL_UNSIGNED_BYTE, 4, true>;  // colours, 0-255 comes out as 0-1
+
+template<typename T>
+struct IsVertexAttribute : std::false_type {};
+
+template<unsigned int Type, unsigned int Count, bool Normalized>
+struct IsVertexAttribute<VertexAttribute<Type, Count, Normalized>> : std::true_type {};
+
+template<typename... Attributes>
+struct AllVertexAttributes : std::true_type {};
+
+template<typename First, typename... Rest>
+struct AllVertexAttributes<First, Rest...> : std::integral_constant<bool, IsVertexAttribute<First>::value && AllVertexAttributes<Rest...>::value> {};
+
+/**
+ * what VertexArray and VertexFormatCache read out of a compile time layout
+ * every Layout type has exactly one of these so its address doubles as the key of the layout
+ */
+struct VertexLayoutInfo
+{
+  const VertexBufferElement *elements;
+  const unsigned int *offsets;
+  unsigned int count;
+  unsigned int stride;
+};
+
+/**
+ * sum of the first n sizes
+ */
+constexpr unsigned int VertexLayoutOffset(std::initializer_list<unsigned int> sizes, std::size_t n)
+{
+  unsigned int offset = 0;
+  std::size_t i = 0;
+  for (unsigned int size : sizes)
   {
-    m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE});
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+    if (i++ == n) break;
+    offset += size;
   }
+  return offset;
+}
+
+template<typename Sequence, typename... Attributes>
+struct VertexLayoutStorage;
+
+template<std::size_t... I, typename... Attributes>
+struct VertexLayoutStorage<std::index_sequence<I...>, Attributes...>
+{
+  static_assert(sizeof...(Attributes) > 0, "a layout needs at least one attribute");
+  static_assert(AllVertexAttributes<Attributes...>::value, "Layout only takes vertex attributes such as Float2 or UByte4Norm");
   
-  inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
-  
-  inline unsigned int GetStride() const { return m_Stride; }
+  static constexpr unsigned int Count = sizeof...(Attributes);
+  static constexpr unsigned int Stride = VertexLayoutOffset({ Attributes::size... }, sizeof...(Attributes));
+  static constexpr VertexBufferElement Elements[] = { { Attributes::type, Attributes::count, Attributes::normalized }... };
+  static constexpr unsigned int Offsets[] = { VertexLayoutOffset({ Attributes::size... }, I)... };
   
+  static const VertexLayoutInfo Info;
 };
 
+template<std::size_t... I, typename... Attributes>
+constexpr unsigned int VertexLayoutStorage<std::index_sequence<I...>, Attributes...>::Count;
+
+template<std::size_t... I, typename... Attributes>
+constexpr unsigned int VertexLayoutStorage<std::index_sequence<I...>, Attributes...>::Stride;
+
+template<std::size_t... I, typename... Attributes>
+constexpr VertexBufferElement VertexLayoutStorage<std::index_sequence<I...>, Attributes...>::Elements[];
+
+template<std::size_t... I, typename... Attributes>
+constexpr unsigned int VertexLayoutStorage<std::index_sequence<I...>, Attributes...>::Offsets[];
+
+template<std::size_t... I, typename... Attributes>
+const VertexLayoutInfo VertexLayoutStorage<std::index_sequence<I...>, Attributes...>::Info = { Elements, Offsets, Count, Stride };
+
+/**
+ * vertex layout worked out at compile time
+ *   using QuadLayout = Layout<Float2, Float2, UByte4Norm>;
+ *   static_assert(QuadLayout::Stride == 20, "");
+ *   va.AddBuffer(vb, QuadLayout());
+ */
+template<typename... Attributes>
+struct Layout : VertexLayoutStorage<std::index_sequence_for<Attributes...>, Attributes...>
+{
+  operator const VertexLayoutInfo&() const { return Layout::Info; }
+};
+
+/*************************** COMPILE TIME LAYOUTS END ***************************/
+
 #endif /* VertexBufferLayout_hpp */
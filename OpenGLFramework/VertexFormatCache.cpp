@@ -0,0 +1,121 @@
+//
+//  VertexFormatCache.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#include "VertexFormatCache.hpp"
+#include "VertexBufferLayout.hpp"
+
+// every layout reads from binding point 0
+static const unsigned int BINDING_INDEX = 0;
+
+static bool IsIntegerAttribute(const VertexBufferElement &element)
+{
+  return element.type == GL_UNSIGNED_INT && !element.normalized;
+}
+
+VertexFormatCache::VertexFormatCache()
+: m_SeparateFormat(GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding)
+{
+}
+
+VertexFormatCache::~VertexFormatCache()
+{
+  for (auto &format : m_Formats)
+  {
+    GLCall(glDeleteVertexArrays(1, &format.second));
+  }
+  for (auto &array : m_BufferArrays)
+  {
+    GLCall(glDeleteVertexArrays(1, &array.second));
+  }
+}
+
+void VertexFormatCache::Bind(const VertexLayoutInfo &layout, const VertexBuffer &vb)
+{
+  if (m_SeparateFormat)
+  {
+    auto found = m_Formats.find(&layout);
+    unsigned int vao = found != m_Formats.end() ? found->second : CreateFormat(layout);
+    
+    GLCall(glBindVertexArray(vao));
+//    the format stays, only the buffer changes
+    GLCall(glBindVertexBuffer(BINDING_INDEX, vb.GetRendererID(), 0, layout.stride));
+    return;
+  }
+  
+  auto found = m_BufferArrays.find(std::make_pair(&layout, vb.GetRendererID()));
+  unsigned int vao = found != m_BufferArrays.end() ? found->second : CreateBufferArray(layout, vb);
+  
+  GLCall(glBindVertexArray(vao));
+}
+
+void VertexFormatCache::Forget(const VertexBuffer &vb)
+{
+  for (auto it = m_BufferArrays.begin(); it != m_BufferArrays.end();)
+  {
+    if (it->first.second == vb.GetRendererID())
+    {
+      GLCall(glDeleteVertexArrays(1, &it->second));
+      it = m_BufferArrays.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+unsigned int VertexFormatCache::CreateFormat(const VertexLayoutInfo &layout)
+{
+  unsigned int vao;
+  GLCall(glGenVertexArrays(1, &vao));
+  GLCall(glBindVertexArray(vao));
+  
+  for (unsigned int i = 0; i < layout.count; i++)
+  {
+    const auto &element = layout.elements[i];
+    
+    GLCall(glEnableVertexAttribArray(i));
+    if (IsIntegerAttribute(element))
+    {
+      GLCall(glVertexAttribIFormat(i, element.count, element.type, layout.offsets[i]));
+    }
+    else
+    {
+      GLCall(glVertexAttribFormat(i, element.count, element.type, element.normalized, layout.offsets[i]));
+    }
+    GLCall(glVertexAttribBinding(i, BINDING_INDEX));
+  }
+  
+  m_Formats[&layout] = vao;
+  return vao;
+}
+
+unsigned int VertexFormatCache::CreateBufferArray(const VertexLayoutInfo &layout, const VertexBuffer &vb)
+{
+  unsigned int vao;
+  GLCall(glGenVertexArrays(1, &vao));
+  GLCall(glBindVertexArray(vao));
+  vb.Bind();
+  
+  for (unsigned int i = 0; i < layout.count; i++)
+  {
+    const auto &element = layout.elements[i];
+    
+    GLCall(glEnableVertexAttribArray(i));
+    if (IsIntegerAttribute(element))
+    {
+      GLCall(glVertexAttribIPointer(i, element.count, element.type, layout.stride, (const void*)(size_t)layout.offsets[i]));
+    }
+    else
+    {
+      GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.stride, (const void*)(size_t)layout.offsets[i]));
+    }
+  }
+  
+  m_BufferArrays[std::make_pair(&layout, vb.GetRendererID())] = vao;
+  return vao;
+}
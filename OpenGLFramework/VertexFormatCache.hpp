@@ -0,0 +1,60 @@
+//
+//  VertexFormatCache.hpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+
+#ifndef VertexFormatCache_hpp
+#define VertexFormatCache_hpp
+
+#include <stdio.h>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+#include "VertexBuffer.hpp"
+
+struct VertexLayoutInfo;
+
+/**
+ * vertex array objects cached by compile time layout, so switching vertex buffers doesnt re-specify the attributes
+ *
+ * with ARB_vertex_attrib_binding (core in 4.3) there is one VAO per layout - the attribute formats
+ * are set once with glVertexAttribFormat and switching buffers is a single glBindVertexBuffer
+ * without it there is one VAO per layout and buffer pair, built the first time the pair is bound, so call Forget before deleting a buffer
+ */
+class VertexFormatCache
+{
+private:
+  bool m_SeparateFormat;
+  
+  std::unordered_map<const VertexLayoutInfo*, unsigned int> m_Formats;
+  std::map<std::pair<const VertexLayoutInfo*, unsigned int>, unsigned int> m_BufferArrays;
+  
+public:
+  VertexFormatCache();
+  ~VertexFormatCache();
+  
+  /**
+   * binds a VAO reading vb with the given layout, bind the index buffer afterwards
+   *   formats.Bind(Layout<Float2, Float2>(), vb);
+   */
+  void Bind(const VertexLayoutInfo &layout, const VertexBuffer &vb);
+  
+  /**
+   * must be called before a VertexBuffer that was bound through the cache is destroyed
+   * the fallback path keys its VAOs by GL buffer name and GL hands deleted names out again,
+   * so a new buffer that gets the same name would be drawn through the stale VAO
+   */
+  void Forget(const VertexBuffer &vb);
+  
+  inline bool UsesSeparateFormat() const { return m_SeparateFormat; }
+  inline unsigned int GetVertexArrayCount() const { return (unsigned int)(m_Formats.size() + m_BufferArrays.size()); }
+  
+private:
+  unsigned int CreateFormat(const VertexLayoutInfo &layout);
+  unsigned int CreateBufferArray(const VertexLayoutInfo &layout, const VertexBuffer &vb);
+};
+
+#endif /* VertexFormatCache_hpp */
@@ -0,0 +1,192 @@
+//
+//  AllocationBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  heap allocations and CPU time per frame of 4000 quads drawn with the real Renderer, RenderQueue and Shader
+//  immediate: shader.SetUniformMat4f and Renderer::Draw for every quad in submission order
+//  queued:    RenderQueue::Submit for every quad and EndFrame, which sorts them and skips the binds that didnt change
+//  the allocations are the global new calls the AllocationTracker saw during the timed frames
+//  run from the repository root so res/shaders can be found
+//
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "Renderer.h"
+#include "RenderQueue.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "VertexBufferLayout.hpp"
+#include "Shader.hpp"
+#include "AllocationTracker.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int FRAMES = 200;
+static const unsigned int DRAWS = 4000;
+static const unsigned int SHADERS = 4;
+static const unsigned int VERTEX_ARRAYS = 8;
+
+struct Draw
+{
+  unsigned int shader, vertexArray;
+  glm::mat4 mvp;
+};
+
+/**
+ * runs a few untimed frames so the caches and the arena have grown, then prints the timed ones
+ */
+template<typename Frame>
+static void Run(const char *name, Frame frame)
+{
+  for (int i = 0; i < 10; i++)
+  {
+    frame();
+    glFinish();
+  }
+
+  const unsigned long long allocations = AllocationTracker::GetAllocations();
+  const unsigned long long bytes = AllocationTracker::GetAllocatedBytes();
+  double ms = 0.0;
+
+  for (int i = 0; i < FRAMES; i++)
+  {
+    const auto start = std::chrono::high_resolution_clock::now();
+    frame();
+    ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / FRAMES;
+
+//    dont let the driver queue up frames, we only want the submission cost
+    glFinish();
+  }
+
+  std::cout << std::fixed << std::setprecision(1) << std::setw(10) << name << std::setw(16) << (double)(AllocationTracker::GetAllocations() - allocations) / FRAMES
+            << std::setw(16) << (double)(AllocationTracker::GetAllocatedBytes() - bytes) / FRAMES
+            << std::setw(16) << std::setprecision(3) << ms;
+}
+
+int main(void)
+{
+  if (!AllocationTracker::IsEnabled())
+  {
+    std::cout << "built with NO_ALLOCATION_TRACKING, the allocation counts will read 0" << std::endl;
+  }
+
+  if (!glfwInit())
+    return -1;
+
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  GLFWwindow* window = glfwCreateWindow(960, 540, "AllocationBenchmark", NULL, NULL);
+  if (!window)
+  {
+    glfwTerminate();
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(0);
+
+  glewExperimental = GL_TRUE;
+  if (glewInit() != GLEW_OK) std::cout << "Error" << std::endl;
+  std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+
+  {
+    const float vertices[] = {
+      0.0f, 0.0f, 0.0f, 0.0f,
+      1.0f, 0.0f, 1.0f, 0.0f,
+      1.0f, 1.0f, 1.0f, 1.0f,
+      0.0f, 1.0f, 0.0f, 1.0f,
+    };
+    const unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexBuffer vb(vertices, sizeof(vertices));
+    IndexBuffer ib(indices, 6);
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+
+    std::vector<VertexArray> vertexArrays(VERTEX_ARRAYS);
+    for (VertexArray &va : vertexArrays) va.AddBuffer(vb, layout);
+
+//    half textured, half flat colour
+    std::vector<Shader*> shaders;
+    for (unsigned int i = 0; i < SHADERS; i++)
+    {
+      shaders.push_back(new Shader(i & 1 ? "res/shaders/Flat.shader" : "res/shaders/Basic.shader"));
+      if (i & 1)
+      {
+        shaders.back()->Bind();
+        shaders.back()->SetUniform4f("u_Color", 0.2f, 0.6f, 1.0f, 1.0f);
+        shaders.back()->SetUniform4f("u_Tint", 1.0f, 1.0f, 1.0f, 1.0f);
+      }
+    }
+
+//    random order so the queue has sorting to do and the immediate path rebinds on most draws
+    std::mt19937 random(42);
+    std::uniform_int_distribution<unsigned int> shader(0, SHADERS - 1);
+    std::uniform_int_distribution<unsigned int> vertexArray(0, VERTEX_ARRAYS - 1);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+    std::vector<Draw> draws(DRAWS);
+    for (Draw &draw : draws)
+    {
+      draw.shader = shader(random);
+      draw.vertexArray = vertexArray(random);
+      draw.mvp = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(position(random), position(random), 0.0f)), glm::vec3(0.02f));
+    }
+
+    Renderer renderer;
+    RenderQueue queue;
+
+    std::cout << DRAWS << " draws a frame over " << SHADERS << " shaders and " << VERTEX_ARRAYS << " vertex arrays, " << FRAMES << " frames" << std::endl;
+    std::cout << std::setw(10) << "path" << std::setw(16) << "allocs/frame" << std::setw(16) << "bytes/frame" << std::setw(16) << "frame (ms)"
+              << std::setw(16) << "shader binds" << std::setw(12) << "va binds" << std::endl;
+
+    Run("immediate", [&]
+    {
+      for (const Draw &draw : draws)
+      {
+        Shader &drawShader = *shaders[draw.shader];
+        drawShader.Bind();
+        drawShader.SetUniformMat4f("u_MVP", draw.mvp);
+        renderer.Draw(vertexArrays[draw.vertexArray], ib, drawShader);
+      }
+    });
+    std::cout << std::setw(16) << DRAWS << std::setw(12) << DRAWS << std::endl;
+
+    Run("queued", [&]
+    {
+      queue.BeginFrame();
+      for (const Draw &draw : draws)
+      {
+        queue.Submit(vertexArrays[draw.vertexArray], ib, *shaders[draw.shader], draw.mvp);
+      }
+      queue.EndFrame();
+    });
+    const RenderQueueStatistics &stats = queue.GetStatistics();
+    std::cout << std::setw(16) << stats.shaderBinds << std::setw(12) << stats.vertexArrayBinds << std::endl;
+
+    std::cout << "frame memory " << stats.frameMemory / 1024 << " KB of " << queue.GetFrameAllocator().GetCapacity() / 1024 << " KB" << std::endl;
+
+    for (Shader *s : shaders) delete s;
+  }
+
+  glfwTerminate();
+
+  return 0;
+}
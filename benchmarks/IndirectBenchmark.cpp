@@ -0,0 +1,173 @@
+//
+//  IndirectBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  CPU frame time against object count for the Renderer::DrawRange fallback
+//  and the GPU driven multi draw indirect path of IndirectRenderer
+//  run from the repository root so res/shaders can be found
+//
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "VertexBufferLayout.hpp"
+#include "Shader.hpp"
+#include "IndirectRenderer.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int FRAMES = 100;
+
+/**
+ * average CPU time in milliseconds to submit one frame
+ */
+static double MeasureFrameTime(IndirectRenderer &renderer, Shader &shader, const glm::mat4 &viewProjection)
+{
+//  warm up so the first upload and shader compilation are not counted
+  renderer.Draw(shader, viewProjection);
+  glFinish();
+  
+  double total = 0.0;
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    renderer.Draw(shader, viewProjection);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    total += std::chrono::duration<double, std::milli>(end - start).count();
+    
+//    dont let the driver queue up frames, we only want the submission cost
+    glFinish();
+  }
+  return total / FRAMES;
+}
+
+int main(void)
+{
+  if (!glfwInit())
+    return -1;
+  
+//  ask for 4.3 so the GPU driven path can run, drop back to 3.3 if we cant get it
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  
+  GLFWwindow* window = glfwCreateWindow(960, 540, "IndirectBenchmark", NULL, NULL);
+  if (!window)
+  {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    window = glfwCreateWindow(960, 540, "IndirectBenchmark", NULL, NULL);
+  }
+  if (!window)
+  {
+    glfwTerminate();
+    return -1;
+  }
+  
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(0);
+  
+  glewExperimental = GL_TRUE;
+  if (glewInit() != GLEW_OK) std::cout << "Error" << std::endl;
+  std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+  
+  {
+//    a cube, position + texture coordinate
+    float vertices[] =
+    {
+      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
+       0.5f, -0.5f, -0.5f, 1.0f, 0.0f,
+       0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+      -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
+      -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+       0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
+       0.5f,  0.5f,  0.5f, 1.0f, 1.0f,
+      -0.5f,  0.5f,  0.5f, 0.0f, 1.0f,
+    };
+    
+    unsigned int indices[] =
+    {
+      0, 1, 2, 2, 3, 0,   // back
+      4, 5, 6, 6, 7, 4,   // front
+      0, 4, 7, 7, 3, 0,   // left
+      1, 5, 6, 6, 2, 1,   // right
+      3, 2, 6, 6, 7, 3,   // top
+      0, 1, 5, 5, 4, 0,   // bottom
+    };
+    
+    VertexArray fallbackVA;
+    VertexBuffer vb(vertices, sizeof(vertices));
+    
+    VertexBufferLayout layout;
+    layout.Push<float>(3);
+    layout.Push<float>(2);
+    fallbackVA.AddBuffer(vb, layout);
+    
+    IndexBuffer ib(indices, 36);
+    
+    Shader shader("res/shaders/Basic.shader");
+    
+    MeshRange cube = { 36, 0, 0 };
+    
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 960.0f / 540.0f, 0.1f, 1000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+    
+    GLCall(glEnable(GL_DEPTH_TEST));
+    
+    std::cout << std::setw(10) << "objects" << std::setw(16) << "fallback (ms)" << std::setw(16) << "indirect (ms)" << std::endl;
+    
+    const unsigned int counts[] = { 1000, 4000, 16000, 64000 };
+    for (unsigned int count : counts)
+    {
+//      a vertex array per renderer, the indirect one adds its object id buffer to it
+      VertexArray indirectVA;
+      indirectVA.AddBuffer(vb, layout);
+      
+      IndirectRenderer fallback(fallbackVA, ib, count, false);
+      IndirectRenderer indirect(indirectVA, ib, count, true);
+      
+//      objects scattered on a grid all around the camera so roughly 1/6 survive culling
+      unsigned int side = 1;
+      while (side * side * side < count) side++;
+      
+      for (unsigned int i = 0; i < count; i++)
+      {
+        glm::vec3 position(float(i % side) - side * 0.5f, float((i / side) % side) - side * 0.5f, float(i / (side * side)) - side * 0.5f);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), position * 3.0f);
+        
+        fallback.AddObject(cube, model, glm::vec3(0.0f), 0.87f);
+        indirect.AddObject(cube, model, glm::vec3(0.0f), 0.87f);
+      }
+      
+      std::cout << std::setw(10) << count << std::fixed << std::setprecision(3)
+                << std::setw(16) << MeasureFrameTime(fallback, shader, viewProjection);
+      
+      if (indirect.IsGPUDriven())
+        std::cout << std::setw(16) << MeasureFrameTime(indirect, shader, viewProjection) << std::endl;
+      else
+        std::cout << std::setw(16) << "unsupported" << std::endl;
+    }
+  }
+  
+  glfwTerminate();
+  
+  return 0;
+}
@@ -0,0 +1,88 @@
+//
+//  LightClusterBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  time to assign 1k / 10k / 100k point lights to the 16x9x24 cluster grid
+//  CPU only, no OpenGL context needed
+//
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "LightClusterBuilder.hpp"
+#include "ThreadPool.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int FRAMES = 30;
+
+static std::vector<PointLight> MakeLights(unsigned int count)
+{
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> spread(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> depth(1.0f, 300.0f);
+  std::uniform_real_distribution<float> radius(1.0f, 6.0f);
+  
+//  scattered through the view frustum of the camera below
+  std::vector<PointLight> lights(count);
+  for (auto &light : lights)
+  {
+    float z = depth(random);
+    light.position = glm::vec3(spread(random) * z * 1.1f, spread(random) * z * 0.6f, -z);
+    light.radius = radius(random);
+    light.color = glm::vec3(1.0f);
+    light.intensity = 1.0f;
+  }
+  return lights;
+}
+
+static double Run(LightClusterBuilder &builder, const std::vector<PointLight> &lights, const glm::mat4 &view)
+{
+  builder.Build(lights, view);
+  
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    builder.Build(lights, view);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  
+  return std::chrono::duration<double, std::milli>(end - start).count() / FRAMES;
+}
+
+int main(void)
+{
+  ThreadPool single(1);
+  ThreadPool &all = ThreadPool::Get();
+  
+  LightClusterBuilder singleBuilder(16, 9, 24, single);
+  LightClusterBuilder allBuilder(16, 9, 24, all);
+  singleBuilder.SetProjection(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+  allBuilder.SetProjection(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+  
+  glm::mat4 view(1.0f);
+  
+  std::cout << "16x9x24 clusters, " << all.GetThreadCount() << " threads" << std::endl;
+  std::cout << std::setw(10) << "lights" << std::setw(18) << "1 thread (ms)" << std::setw(18) << "all (ms)"
+            << std::setw(18) << "light indices" << std::endl;
+  
+  const unsigned int counts[] = { 1000, 10000, 100000 };
+  for (unsigned int count : counts)
+  {
+    std::vector<PointLight> lights = MakeLights(count);
+    
+    double singleTime = Run(singleBuilder, lights, view);
+    double allTime = Run(allBuilder, lights, view);
+    
+    std::cout << std::setw(10) << count << std::fixed << std::setprecision(3)
+              << std::setw(18) << singleTime << std::setw(18) << allTime
+              << std::setw(18) << allBuilder.GetLightIndices().size() << std::endl;
+  }
+  
+  return 0;
+}
@@ -0,0 +1,166 @@
+//
+//  MeshLODBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  builds an LOD chain for a dense bumpy sphere, then flies a camera through a field of them
+//  and counts the triangles drawn and how often objects switch level, with and without hysteresis
+//  CPU only, no OpenGL context needed
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "MeshLOD.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+static const unsigned int SUBDIVISIONS = 6;       // 81920 triangles
+static const unsigned int OBJECTS = 2000;
+static const int FRAMES = 600;
+static const float SCREEN_HEIGHT = 1080.0f;
+static const float OBJECT_SIZE = 4.0f;
+
+/**
+ * icosphere pushed in and out a little so there is something for the simplifier to keep
+ * 3 floats per vertex
+ */
+static void MakeSphere(std::vector<float> &vertices, std::vector<unsigned int> &indices)
+{
+  const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+  std::vector<glm::vec3> points = {
+    {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+    {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}
+  };
+  indices = {
+    0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+    3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1
+  };
+  for (auto &p : points) p = glm::normalize(p);
+
+  for (unsigned int s = 0; s < SUBDIVISIONS; s++)
+  {
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints;
+    auto midpoint = [&](unsigned int a, unsigned int b)
+    {
+      auto key = std::make_pair(std::min(a, b), std::max(a, b));
+      auto it = midpoints.find(key);
+      if (it != midpoints.end()) return it->second;
+
+      points.push_back(glm::normalize(points[a] + points[b]));
+      return midpoints[key] = (unsigned int)points.size() - 1;
+    };
+
+    std::vector<unsigned int> next;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+      unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+      unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+      next.insert(next.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+    }
+    indices.swap(next);
+  }
+
+  vertices.clear();
+  for (const auto &p : points)
+  {
+    float bump = OBJECT_SIZE * (1.0f + 0.05f * std::sin(p.x * 9.0f) * std::sin(p.y * 7.0f) * std::sin(p.z * 8.0f));
+    vertices.push_back(p.x * bump);
+    vertices.push_back(p.y * bump);
+    vertices.push_back(p.z * bump);
+  }
+}
+
+struct FlyThrough
+{
+  unsigned long long triangles = 0;
+  unsigned long long fullTriangles = 0;
+  unsigned long long levelChanges = 0;
+  unsigned int levelDraws[MeshLODChain::MaxLevels] = {};
+};
+
+static FlyThrough Fly(const MeshLODChain &chain, const std::vector<glm::vec3> &positions, float hysteresis)
+{
+  FlyThrough result;
+  std::vector<unsigned int> levels(positions.size(), 0);
+  LODStatistics stats;
+
+  const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+//    the camera bobs back and forth through the field so objects cross the thresholds both ways
+    const float z = 100.0f * std::sin(frame * 0.02f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 2.0f, z), glm::vec3(0.0f, 2.0f, z - 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    stats.Reset();
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      const glm::vec4 center = view * glm::vec4(positions[i] + chain.GetCenter(), 1.0f);
+      const float screenRadius = MeshLODChain::ProjectedRadius(glm::vec3(center.x, center.y, center.z), chain.GetRadius(), projection[1][1], SCREEN_HEIGHT);
+
+      const unsigned int level = chain.SelectLevel(screenRadius, levels[i], 1.0f, hysteresis);
+      if (frame > 0 && level != levels[i]) result.levelChanges++;
+      levels[i] = level;
+
+      stats.Record(chain, level);
+    }
+
+    result.triangles += stats.triangles;
+    result.fullTriangles += stats.fullTriangles;
+    for (unsigned int l = 0; l < MeshLODChain::MaxLevels; l++) result.levelDraws[l] += stats.levelDraws[l];
+  }
+
+  return result;
+}
+
+int main(void)
+{
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  MakeSphere(vertices, indices);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  MeshLODChain chain(vertices.data(), (unsigned int)vertices.size() / 3, 3, indices, 6, 0.5f);
+  auto end = std::chrono::high_resolution_clock::now();
+
+  std::cout << "LOD chain for " << indices.size() / 3 << " triangles built in "
+            << std::fixed << std::setprecision(1) << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+
+  std::cout << std::setw(8) << "level" << std::setw(12) << "triangles" << std::setw(14) << "error" << std::endl;
+  for (unsigned int l = 0; l < chain.GetLevelCount(); l++)
+  {
+    std::cout << std::setw(8) << l << std::setw(12) << chain.GetLevels()[l].indexCount / 3
+              << std::setw(14) << std::setprecision(5) << chain.GetLevels()[l].error << std::endl;
+  }
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> spread(-100.0f, 100.0f);
+  std::vector<glm::vec3> positions(OBJECTS);
+  for (auto &p : positions) p = glm::vec3(spread(random), 0.0f, spread(random));
+
+  std::cout << std::endl << OBJECTS << " objects, " << FRAMES << " frames, 1 pixel error" << std::endl;
+  std::cout << std::setw(12) << "hysteresis" << std::setw(16) << "triangles/frame" << std::setw(12) << "reduction"
+            << std::setw(16) << "switches/frame" << "   draws per level" << std::endl;
+
+  const float hysteresis[] = { 0.0f, 0.5f };
+  for (float h : hysteresis)
+  {
+    FlyThrough result = Fly(chain, positions, h);
+
+    std::cout << std::setw(12) << std::setprecision(1) << h
+              << std::setw(16) << result.triangles / FRAMES
+              << std::setw(11) << std::setprecision(1) << 100.0 * (1.0 - (double)result.triangles / result.fullTriangles) << "%"
+              << std::setw(16) << std::setprecision(2) << (double)result.levelChanges / FRAMES << "  ";
+    for (unsigned int l = 0; l < chain.GetLevelCount(); l++) std::cout << " " << result.levelDraws[l] / FRAMES;
+    std::cout << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,239 @@
+//
+//  OcclusionBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  a street level camera turning around in a grid of buildings, the buildings are the occluders
+//  and small props scattered between them are the objects being tested
+//  props outside the frustum are dropped first, the culled share is out of the ones left
+//  reports the share of props hidden and the culling cost per frame, CPU only, no OpenGL context needed
+//  first checks IsOccluded against a per pixel test of the full depth buffer on 20k random boxes,
+//  exits with 1 if any answer differs
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "Frustum.hpp"
+#include "OcclusionCuller.hpp"
+#include "ThreadPool.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int FRAMES = 120;
+static const int GRID = 20;                 // 20x20 blocks
+static const float BLOCK = 20.0f;           // block spacing, buildings are 14 wide so the streets are 6
+static const unsigned int OBJECTS = 20000;
+
+// unit cube, 8 corners and 12 triangles
+static const float CUBE_VERTICES[] = {
+  0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,
+  0, 0, 1,  1, 0, 1,  1, 1, 1,  0, 1, 1
+};
+static const unsigned int CUBE_INDICES[] = {
+  0, 2, 1, 0, 3, 2,   4, 5, 6, 4, 6, 7,   0, 1, 5, 0, 5, 4,
+  3, 6, 2, 3, 7, 6,   0, 4, 7, 0, 7, 3,   1, 2, 6, 1, 6, 5
+};
+
+struct Box
+{
+  glm::vec3 min, max;
+};
+
+struct Result
+{
+  double rasterizeMs = 0.0, hierarchyMs = 0.0, testMs = 0.0;
+  double culledPercent = 0.0;
+  unsigned int triangles = 0;
+  unsigned int inFrustum = 0;
+};
+
+/**
+ * what IsOccluded has to answer, every pixel under the box checked without the hierarchy
+ */
+static bool IsOccludedBruteForce(const OcclusionCuller &culler, const glm::mat4 &viewProjection, const Box &box)
+{
+  const int width = (int)culler.GetWidth(), height = (int)culler.GetHeight();
+
+  float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+  float boxNear = 1.0f;
+
+  for (int i = 0; i < 8; i++)
+  {
+    const glm::vec4 clip = viewProjection * glm::vec4(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z, 1.0f);
+    if (clip.z < -clip.w || clip.w <= 0.0f) return false;
+
+    const float x = (clip.x / clip.w * 0.5f + 0.5f) * width;
+    const float y = (clip.y / clip.w * 0.5f + 0.5f) * height;
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+    boxNear = std::min(boxNear, clip.z / clip.w * 0.5f + 0.5f);
+  }
+
+  const int x0 = std::max(0, (int)std::floor(minX)), y0 = std::max(0, (int)std::floor(minY));
+  const int x1 = std::min(width - 1, (int)std::floor(maxX)), y1 = std::min(height - 1, (int)std::floor(maxY));
+  if (x0 > x1 || y0 > y1) return false;
+
+  for (int y = y0; y <= y1; y++)
+  {
+    for (int x = x0; x <= x1; x++)
+    {
+      if (culler.GetDepth()[y * width + x] >= boxNear) return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * random boxes of every size anywhere in the city from a few directions, returns how many answers differ
+ */
+static unsigned int CheckAgainstBruteForce(OcclusionCuller &culler, const std::vector<Box> &buildings, unsigned int &occluded)
+{
+  const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 1000.0f);
+
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> position(0.0f, GRID * BLOCK);
+  std::uniform_real_distribution<float> height(0.0f, 30.0f);
+  std::uniform_real_distribution<float> size(0.1f, 10.0f);
+
+  unsigned int mismatches = 0;
+  occluded = 0;
+
+  for (int view = 0; view < 8; view++)
+  {
+    const float angle = view * 6.2831853f / 8;
+    const glm::vec3 eye(GRID * BLOCK * 0.5f - 3.0f, 1.7f, GRID * BLOCK * 0.5f - 3.0f);
+    const glm::mat4 viewProjection = projection * glm::lookAt(eye, eye + glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    culler.BeginFrame(viewProjection);
+    for (const Box &building : buildings)
+    {
+      glm::mat4 model = glm::translate(glm::mat4(1.0f), building.min);
+      model = glm::scale(model, building.max - building.min);
+      culler.AddOccluder(CUBE_VERTICES, 8, 3, CUBE_INDICES, 36, model);
+    }
+    culler.Rasterize();
+
+    for (int i = 0; i < 2500; i++)
+    {
+      const glm::vec3 min(position(random), height(random), position(random));
+      const Box box = { min, min + glm::vec3(size(random), size(random), size(random)) };
+
+      const bool expected = IsOccludedBruteForce(culler, viewProjection, box);
+      if (culler.IsOccluded(box.min, box.max) != expected) mismatches++;
+      if (expected) occluded++;
+    }
+  }
+
+  return mismatches;
+}
+
+static Result Run(OcclusionCuller &culler, const std::vector<Box> &buildings, const std::vector<Box> &objects)
+{
+  Result result;
+  const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 1000.0f);
+
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+//    stand at a crossing near the middle and look around
+    const float angle = frame * 6.2831853f / FRAMES;
+    const glm::vec3 eye(GRID * BLOCK * 0.5f - 3.0f, 1.7f, GRID * BLOCK * 0.5f - 3.0f);
+    const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    culler.BeginFrame(projection * view);
+    for (const Box &building : buildings)
+    {
+      glm::mat4 model = glm::translate(glm::mat4(1.0f), building.min);
+      model = glm::scale(model, building.max - building.min);
+      culler.AddOccluder(CUBE_VERTICES, 8, 3, CUBE_INDICES, 36, model);
+    }
+    culler.Rasterize();
+
+    Frustum frustum(projection * view);
+    unsigned int inFrustum = 0;
+    for (const Box &object : objects)
+    {
+      if (!frustum.IntersectsAABB(object.min, object.max)) continue;
+
+      inFrustum++;
+      culler.IsOccluded(object.min, object.max);
+    }
+
+    const OcclusionStatistics &stats = culler.GetStatistics();
+    result.rasterizeMs += stats.rasterizeMs / FRAMES;
+    result.hierarchyMs += stats.hierarchyMs / FRAMES;
+    result.testMs += stats.testMs / FRAMES;
+    result.culledPercent += stats.GetCulledPercent() / FRAMES;
+    result.triangles += stats.occluderTriangles / FRAMES;
+    result.inFrustum += inFrustum / FRAMES;
+  }
+
+  return result;
+}
+
+int main(void)
+{
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> height(8.0f, 40.0f);
+  std::uniform_real_distribution<float> position(0.0f, GRID * BLOCK);
+  std::uniform_real_distribution<float> size(0.3f, 1.5f);
+
+  std::vector<Box> buildings;
+  for (int z = 0; z < GRID; z++)
+  {
+    for (int x = 0; x < GRID; x++)
+    {
+      buildings.push_back({ glm::vec3(x * BLOCK, 0.0f, z * BLOCK), glm::vec3(x * BLOCK + 14.0f, height(random), z * BLOCK + 14.0f) });
+    }
+  }
+
+//  props go in the streets only, there would be no point testing the inside of a building
+  std::vector<Box> objects;
+  while (objects.size() < OBJECTS)
+  {
+    const glm::vec3 p(position(random), 0.0f, position(random));
+    if (std::fmod(p.x, BLOCK) < 14.5f && std::fmod(p.z, BLOCK) < 14.5f) continue;
+
+    const float s = size(random);
+    objects.push_back({ p, p + glm::vec3(s, s * 2.0f, s) });
+  }
+
+  ThreadPool single(1);
+  OcclusionCuller singleCuller(256, 128, single);
+  OcclusionCuller allCuller(256, 128, ThreadPool::Get());
+
+  std::cout << GRID * GRID << " buildings, " << objects.size() << " props, 256x128 depth, "
+            << ThreadPool::Get().GetThreadCount() << " threads" << std::endl;
+
+  unsigned int occluded = 0;
+  const unsigned int mismatches = CheckAgainstBruteForce(allCuller, buildings, occluded);
+  std::cout << "against the per pixel test: " << mismatches << " mismatches in 20000 random boxes, " << occluded << " occluded" << std::endl << std::endl;
+  if (mismatches) return 1;
+
+  std::cout << std::setw(10) << "threads" << std::setw(12) << "triangles" << std::setw(12) << "in frustum" << std::setw(14) << "raster (ms)"
+            << std::setw(16) << "hierarchy (ms)" << std::setw(12) << "test (ms)" << std::setw(12) << "total (ms)" << std::setw(10) << "culled" << std::endl;
+
+  OcclusionCuller *cullers[] = { &singleCuller, &allCuller };
+  for (OcclusionCuller *culler : cullers)
+  {
+    Run(*culler, buildings, objects);
+    Result result = Run(*culler, buildings, objects);
+
+    std::cout << std::setw(10) << (culler == &singleCuller ? 1 : ThreadPool::Get().GetThreadCount())
+              << std::setw(12) << result.triangles << std::setw(12) << result.inFrustum << std::fixed << std::setprecision(3)
+              << std::setw(14) << result.rasterizeMs << std::setw(16) << result.hierarchyMs << std::setw(12) << result.testMs
+              << std::setw(12) << result.rasterizeMs + result.hierarchyMs + result.testMs
+              << std::setw(9) << std::setprecision(1) << result.culledPercent << "%" << std::endl;
+  }
+
+  return 0;
+}
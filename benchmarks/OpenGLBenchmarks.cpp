@@ -0,0 +1,690 @@
+//
+//  OpenGLBenchmarks.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  the standard scenes for gating upgrades on performance, run under a hidden window so it works
+//  on a headless machine with llvmpipe (LIBGL_ALWAYS_SOFTWARE=1, xvfb-run or a glfw 3.4 OSMesa build)
+//
+//    quads      many small quads through RenderQueue::Submit / EndFrame, 2 shaders and 2 vertex arrays
+//    textures   a different texture bound for every draw
+//    uniforms   4 uniforms set before every draw
+//    shaders    every 330 shader in res/shaders compiled and linked again
+//
+//  writes the results as JSON and compares them against a baseline written by an earlier run
+//  the fastest frame, setup time, startup time and allocations are checked, the fastest frame moves the least
+//  when the machine is busy with something else. draws per second follows from the median frame time
+//  the scenes run again while something still looks slower, up to --runs times, and every metric keeps
+//  its best run - a regression has to show up every time. --update-baseline always does all the runs
+//
+//    OpenGLBenchmarks [--output results.json] [--baseline baseline.json] [--update-baseline]
+//                     [--threshold 0.15] [--frames 200] [--runs 3]
+//
+//  exit code 0 when nothing got slower than the threshold, 1 on a regression, 2 when the baseline
+//  cant be read, 77 when there is no context so ctest shows it as skipped
+//  run from the repository root so res/shaders can be found
+//
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "RenderQueue.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "VertexBufferLayout.hpp"
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "FrameBuffer.hpp"
+#include "AllocationTracker.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int WIDTH = 960;
+static const int HEIGHT = 540;
+
+static const unsigned int QUADS = 10000;
+static const unsigned int TEXTURES = 256;
+static const unsigned int TEXTURE_DRAWS = 4096;
+static const unsigned int UNIFORM_DRAWS = 10000;
+
+static const int EXIT_REGRESSION = 1;
+static const int EXIT_USAGE = 2;
+static const int EXIT_SKIPPED = 77;
+
+// the ones a 3.3 context can compile, Cull and Indirect need 4.3
+static const char *SHADERS[] = {
+  "res/shaders/Basic.shader", "res/shaders/Flat.shader", "res/shaders/Lit.shader",
+  "res/shaders/Particle.shader", "res/shaders/SDFText.shader"
+};
+
+struct Options
+{
+  std::string output = "benchmark_results.json";
+  std::string baseline;
+  bool updateBaseline = false;
+  double threshold = 0.15;
+  int frames = 200;
+  int runs = 3;
+};
+
+struct SceneResult
+{
+  std::string name;
+  unsigned int drawsPerFrame = 0;
+  double setupMs = 0.0;             // creating the buffers, textures and shaders for the scene
+  double cpuFrameMs = 0.0;          // median submission time, the glFinish after every frame is not counted
+  double minFrameMs = 0.0;          // fastest frame, what the regression check uses
+  double drawsPerSecond = 0.0;
+  double allocationsPerFrame = 0.0;
+};
+
+struct Results
+{
+  std::string renderer;
+  std::string version;
+  int frames = 0;
+  double startupMs = 0.0;           // process start to a context ready to draw
+  std::vector<SceneResult> scenes;
+};
+
+static double MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * runs a few untimed frames, then frames timed ones and fills in the frame time, draws per second and allocations
+ */
+template<typename Frame>
+static void Measure(SceneResult &result, int frames, Frame frame)
+{
+  for (int i = 0; i < 5; i++)
+  {
+    frame();
+    glFinish();
+  }
+
+//  allocated before the counting starts
+  std::vector<double> times(frames);
+  const unsigned long long allocations = AllocationTracker::GetAllocations();
+
+  for (int i = 0; i < frames; i++)
+  {
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    frame();
+    times[i] = MillisecondsSince(start);
+
+//    dont let the driver queue up frames, we only want the submission cost
+    glFinish();
+  }
+
+  result.allocationsPerFrame = (double)(AllocationTracker::GetAllocations() - allocations) / frames;
+
+  std::sort(times.begin(), times.end());
+  result.cpuFrameMs = times[frames / 2];
+  result.minFrameMs = times[0];
+  result.drawsPerSecond = result.cpuFrameMs > 0.0 ? result.drawsPerFrame / (result.cpuFrameMs / 1000.0) : 0.0;
+}
+
+/**
+ * the best of every metric over the runs so far, the first run is taken as it is
+ */
+static void KeepBest(std::vector<SceneResult> &best, const SceneResult *begin, const SceneResult *end)
+{
+  if (best.empty())
+  {
+    best.assign(begin, end);
+    return;
+  }
+
+  for (size_t i = 0; i < best.size(); i++)
+  {
+    const SceneResult &run = begin[i];
+    best[i].setupMs = std::min(best[i].setupMs, run.setupMs);
+    best[i].cpuFrameMs = std::min(best[i].cpuFrameMs, run.cpuFrameMs);
+    best[i].minFrameMs = std::min(best[i].minFrameMs, run.minFrameMs);
+    best[i].drawsPerSecond = std::max(best[i].drawsPerSecond, run.drawsPerSecond);
+    best[i].allocationsPerFrame = std::min(best[i].allocationsPerFrame, run.allocationsPerFrame);
+  }
+}
+
+/*************************** SCENES START ***************************/
+
+// a unit quad, position + texture coordinate
+static const float QUAD_VERTICES[] = {
+  0.0f, 0.0f, 0.0f, 0.0f,
+  1.0f, 0.0f, 1.0f, 0.0f,
+  1.0f, 1.0f, 1.0f, 1.0f,
+  0.0f, 1.0f, 0.0f, 1.0f,
+};
+static const unsigned int QUAD_INDICES[] = { 0, 1, 2, 2, 3, 0 };
+
+/**
+ * mvps for count quads of size pixels laid out over the screen in rows
+ */
+static std::vector<glm::mat4> LayoutQuads(unsigned int count, float size)
+{
+  const glm::mat4 projection = glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT, -1.0f, 1.0f);
+  const unsigned int columns = (unsigned int)(WIDTH / size);
+
+  std::vector<glm::mat4> mvps(count);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    const float x = (i % columns) * size;
+    const float y = std::fmod((i / columns) * size, (float)HEIGHT);
+    mvps[i] = projection * glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f)), glm::vec3(size * 0.8f, size * 0.8f, 1.0f));
+  }
+  return mvps;
+}
+
+static SceneResult RunQuads(RenderQueue &queue, const VertexBuffer &vb, const VertexBufferLayout &layout, const IndexBuffer &ib, int frames)
+{
+  SceneResult result;
+  result.name = "quads";
+  result.drawsPerFrame = QUADS;
+
+  const auto start = std::chrono::high_resolution_clock::now();
+
+  VertexArray vertexArrays[2];
+  vertexArrays[0].AddBuffer(vb, layout);
+  vertexArrays[1].AddBuffer(vb, layout);
+
+  Shader basic("res/shaders/Basic.shader");
+  Shader flat("res/shaders/Flat.shader");
+  Shader *shaders[] = { &basic, &flat };
+
+  flat.Bind();
+  flat.SetUniform4f("u_Color", 0.2f, 0.6f, 1.0f, 1.0f);
+  flat.SetUniform4f("u_Tint", 1.0f, 1.0f, 1.0f, 1.0f);
+
+  const std::vector<glm::mat4> mvps = LayoutQuads(QUADS, 8.0f);
+  result.setupMs = MillisecondsSince(start);
+
+//  interleaved so the sort in EndFrame has something to do
+  Measure(result, frames, [&]
+  {
+    queue.BeginFrame();
+    for (unsigned int i = 0; i < QUADS; i++)
+    {
+      queue.Submit(vertexArrays[i & 1], ib, *shaders[(i >> 1) & 1], mvps[i]);
+    }
+    queue.EndFrame();
+  });
+
+  return result;
+}
+
+static SceneResult RunTextures(Renderer &renderer, const VertexArray &va, const IndexBuffer &ib, int frames)
+{
+  SceneResult result;
+  result.name = "textures";
+  result.drawsPerFrame = TEXTURE_DRAWS;
+
+  const auto start = std::chrono::high_resolution_clock::now();
+
+  Shader shader("res/shaders/Basic.shader");
+  shader.Bind();
+  shader.SetUniform1i("u_Texture", 0);
+
+//  64x64 checkers in a different colour each
+  std::vector<std::unique_ptr<Texture>> textures;
+  std::vector<unsigned char> pixels(64 * 64 * 4);
+  for (unsigned int t = 0; t < TEXTURES; t++)
+  {
+    for (unsigned int p = 0; p < 64 * 64; p++)
+    {
+      const bool on = ((p % 64) / 8 + (p / 64) / 8) & 1;
+      pixels[p * 4 + 0] = on ? (unsigned char)t : 0;
+      pixels[p * 4 + 1] = on ? (unsigned char)(t * 7) : 0;
+      pixels[p * 4 + 2] = on ? (unsigned char)(t * 13) : 0;
+      pixels[p * 4 + 3] = 255;
+    }
+
+    textures.emplace_back(new Texture(64, 64, GL_RGBA8, GL_RGBA));
+    textures.back()->SetData(0, 0, 64, 64, pixels.data());
+  }
+
+  const std::vector<glm::mat4> mvps = LayoutQuads(TEXTURE_DRAWS, 14.0f);
+  result.setupMs = MillisecondsSince(start);
+
+  Measure(result, frames, [&]
+  {
+    for (unsigned int i = 0; i < TEXTURE_DRAWS; i++)
+    {
+      textures[i % TEXTURES]->Bind(0);
+      shader.SetUniformMat4f("u_MVP", mvps[i]);
+      renderer.Draw(va, ib, shader);
+    }
+  });
+
+  return result;
+}
+
+static SceneResult RunUniforms(Renderer &renderer, const VertexArray &va, const IndexBuffer &ib, int frames)
+{
+  SceneResult result;
+  result.name = "uniforms";
+  result.drawsPerFrame = UNIFORM_DRAWS;
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  Shader shader("res/shaders/Flat.shader");
+  const std::vector<glm::mat4> mvps = LayoutQuads(UNIFORM_DRAWS, 8.0f);
+  result.setupMs = MillisecondsSince(start);
+
+  Measure(result, frames, [&]
+  {
+    for (unsigned int i = 0; i < UNIFORM_DRAWS; i++)
+    {
+      const float shade = (i & 255) / 255.0f;
+
+      shader.Bind();
+      shader.SetUniformMat4f("u_MVP", mvps[i]);
+      shader.SetUniform2f("u_Offset", 0.1f * (i & 1), 0.1f * (i & 2));
+      shader.SetUniform4f("u_Color", shade, 1.0f - shade, 0.5f, 1.0f);
+      shader.SetUniform4f("u_Tint", 1.0f, 1.0f, shade, 1.0f);
+      renderer.Draw(va, ib, shader);
+    }
+  });
+
+  return result;
+}
+
+static SceneResult RunShaders(int frames)
+{
+  SceneResult result;
+  result.name = "shaders";
+
+//  a frame here is every shader loaded and thrown away, that is slow so there are fewer of them
+  Measure(result, std::max(frames / 20, 5), []
+  {
+    for (const char *path : SHADERS)
+    {
+      Shader shader(path);
+    }
+  });
+
+  return result;
+}
+
+/*************************** SCENES END ***************************/
+
+/*************************** JSON START ***************************/
+
+static std::string Escape(const std::string &text)
+{
+  std::string escaped;
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+static bool WriteResults(const std::string &path, const Results &results)
+{
+  std::ofstream stream(path);
+  if (!stream) return false;
+
+  stream << std::fixed << std::setprecision(4);
+  stream << "{\n";
+  stream << "  \"renderer\": \"" << Escape(results.renderer) << "\",\n";
+  stream << "  \"version\": \"" << Escape(results.version) << "\",\n";
+  stream << "  \"frames\": " << results.frames << ",\n";
+  stream << "  \"startupMs\": " << results.startupMs << ",\n";
+  stream << "  \"scenes\": [\n";
+
+  for (size_t i = 0; i < results.scenes.size(); i++)
+  {
+    const SceneResult &scene = results.scenes[i];
+    stream << "    { \"name\": \"" << scene.name << "\", \"draws\": " << scene.drawsPerFrame
+           << ", \"setupMs\": " << scene.setupMs << ", \"cpuFrameMs\": " << scene.cpuFrameMs << ", \"minFrameMs\": " << scene.minFrameMs
+           << ", \"drawsPerSecond\": " << std::setprecision(0) << scene.drawsPerSecond << std::setprecision(4)
+           << ", \"allocationsPerFrame\": " << scene.allocationsPerFrame << " }"
+           << (i + 1 < results.scenes.size() ? ",\n" : "\n");
+  }
+
+  stream << "  ]\n";
+  stream << "}\n";
+  return (bool)stream;
+}
+
+/**
+ * index of the quote closing the string that opens at begin, skipping escaped ones
+ */
+static size_t FindStringEnd(const std::string &text, size_t begin)
+{
+  for (size_t i = begin + 1; i < text.size(); i++)
+  {
+    if (text[i] == '\\') i++;
+    else if (text[i] == '"') return i;
+  }
+  return std::string::npos;
+}
+
+/**
+ * only reads what WriteResults writes - every "key": value pair in order, a "name" starts the next scene
+ */
+static bool ReadResults(const std::string &path, Results &results)
+{
+  std::ifstream stream(path);
+  if (!stream) return false;
+  const std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+  SceneResult *scene = nullptr;
+  size_t i = 0;
+  while ((i = text.find('"', i)) != std::string::npos)
+  {
+    const size_t keyEnd = FindStringEnd(text, i);
+    if (keyEnd == std::string::npos) break;
+
+    const std::string key = text.substr(i + 1, keyEnd - i - 1);
+    i = keyEnd + 1;
+
+//    a string that isnt followed by a colon is a value we already read
+    const size_t colon = text.find_first_not_of(" \t\r\n", i);
+    if (colon == std::string::npos || text[colon] != ':') continue;
+
+    const size_t value = text.find_first_not_of(" \t\r\n", colon + 1);
+    if (value == std::string::npos) break;
+
+    if (text[value] == '"')
+    {
+      const size_t valueEnd = FindStringEnd(text, value);
+      if (valueEnd == std::string::npos) break;
+
+      const std::string string = text.substr(value + 1, valueEnd - value - 1);
+      if (key == "name")
+      {
+        results.scenes.push_back(SceneResult());
+        scene = &results.scenes.back();
+        scene->name = string;
+      }
+      else if (key == "renderer") results.renderer = string;
+      else if (key == "version") results.version = string;
+
+      i = valueEnd + 1;
+      continue;
+    }
+
+    const double number = std::strtod(text.c_str() + value, nullptr);
+    if (!scene)
+    {
+      if (key == "frames") results.frames = (int)number;
+      else if (key == "startupMs") results.startupMs = number;
+    }
+    else if (key == "draws") scene->drawsPerFrame = (unsigned int)number;
+    else if (key == "setupMs") scene->setupMs = number;
+    else if (key == "cpuFrameMs") scene->cpuFrameMs = number;
+    else if (key == "minFrameMs") scene->minFrameMs = number;
+    else if (key == "drawsPerSecond") scene->drawsPerSecond = number;
+    else if (key == "allocationsPerFrame") scene->allocationsPerFrame = number;
+
+    i = value;
+  }
+
+  return !results.scenes.empty();
+}
+
+/*************************** JSON END ***************************/
+
+/**
+ * prints one row of the comparison, true if current is worse than baseline by more than the threshold
+ * slack is an absolute allowance so tiny numbers dont fail on noise
+ */
+static bool Compare(const std::string &scene, const char *metric, double baseline, double current, double threshold, double slack, bool print)
+{
+  const bool regression = current > baseline * (1.0 + threshold) + slack;
+  if (!print) return regression;
+
+  const double change = baseline > 0.0 ? 100.0 * (current - baseline) / baseline : 0.0;
+
+  std::cout << std::setw(10) << scene << std::setw(22) << metric << std::fixed << std::setprecision(3)
+            << std::setw(14) << baseline << std::setw(14) << current
+            << std::setw(9) << std::setprecision(1) << change << "%" << (regression ? "   REGRESSION" : "") << std::endl;
+  return regression;
+}
+
+static int CompareResults(const Results &baseline, const Results &results, double threshold, bool print)
+{
+  if (print && baseline.renderer != results.renderer)
+  {
+    std::cout << "warning: the baseline was recorded on " << baseline.renderer << ", the numbers may not be comparable" << std::endl;
+  }
+
+  if (print)
+  {
+    std::cout << std::setw(10) << "scene" << std::setw(22) << "metric" << std::setw(14) << "baseline"
+              << std::setw(14) << "current" << std::setw(10) << "change" << std::endl;
+  }
+
+//  startup and setup are timed once and not over many frames, so they get more slack
+  int regressions = 0;
+  regressions += Compare("startup", "startupMs", baseline.startupMs, results.startupMs, threshold, 5.0, print);
+
+  for (const SceneResult &scene : results.scenes)
+  {
+    auto found = std::find_if(baseline.scenes.begin(), baseline.scenes.end(), [&](const SceneResult &s) { return s.name == scene.name; });
+    if (found == baseline.scenes.end())
+    {
+      if (print) std::cout << std::setw(10) << scene.name << "  not in the baseline" << std::endl;
+      continue;
+    }
+
+    regressions += Compare(scene.name, "minFrameMs", found->minFrameMs, scene.minFrameMs, threshold, 0.01, print);
+    regressions += Compare(scene.name, "setupMs", found->setupMs, scene.setupMs, threshold, 5.0, print);
+    regressions += Compare(scene.name, "allocationsPerFrame", found->allocationsPerFrame, scene.allocationsPerFrame, threshold, 0.5, print);
+  }
+
+  return regressions;
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const bool hasValue = i + 1 < argc;
+
+    if (!strcmp(argv[i], "--output") && hasValue) options.output = argv[++i];
+    else if (!strcmp(argv[i], "--baseline") && hasValue) options.baseline = argv[++i];
+    else if (!strcmp(argv[i], "--update-baseline")) options.updateBaseline = true;
+    else if (!strcmp(argv[i], "--threshold") && hasValue) options.threshold = std::atof(argv[++i]);
+    else if (!strcmp(argv[i], "--frames") && hasValue) options.frames = std::max(std::atoi(argv[++i]), 1);
+    else if (!strcmp(argv[i], "--runs") && hasValue) options.runs = std::max(std::atoi(argv[++i]), 1);
+    else return false;
+  }
+
+  if (options.updateBaseline && options.baseline.empty()) options.baseline = "benchmarks/baseline.json";
+  return true;
+}
+
+static GLFWwindow* CreateHiddenWindow()
+{
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  return glfwCreateWindow(WIDTH, HEIGHT, "OpenGLBenchmarks", NULL, NULL);
+}
+
+/**
+ * a hidden window on the display if there is one, otherwise an OSMesa context when glfw is new enough to have one
+ */
+static GLFWwindow* CreateContext()
+{
+  if (glfwInit())
+  {
+    GLFWwindow *window = CreateHiddenWindow();
+    if (window) return window;
+    glfwTerminate();
+  }
+
+#if defined(GLFW_PLATFORM_NULL) && defined(GLFW_OSMESA_CONTEXT_API)
+  glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+  if (glfwInit())
+  {
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    GLFWwindow *window = CreateHiddenWindow();
+    if (window) return window;
+    glfwTerminate();
+  }
+#endif
+
+  return nullptr;
+}
+
+int main(int argc, char **argv)
+{
+  const auto processStart = std::chrono::high_resolution_clock::now();
+
+  Options options;
+  if (!ParseOptions(argc, argv, options))
+  {
+    std::cout << "usage: OpenGLBenchmarks [--output results.json] [--baseline baseline.json] [--update-baseline]"
+                 " [--threshold 0.15] [--frames 200] [--runs 3]" << std::endl;
+    return EXIT_USAGE;
+  }
+
+//  a gate without a baseline would pass every time, so that is an error and not a skip
+  Results baseline;
+  const bool compare = !options.baseline.empty() && !options.updateBaseline;
+  if (compare && !ReadResults(options.baseline, baseline))
+  {
+    std::cout << "no baseline at " << options.baseline << ", run with --update-baseline to record one" << std::endl;
+    return EXIT_USAGE;
+  }
+
+  GLFWwindow *window = CreateContext();
+  if (!window)
+  {
+    std::cout << "no OpenGL 3.3 context, skipping" << std::endl;
+    return EXIT_SKIPPED;
+  }
+
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(0);
+
+//  glew built for GLX still loads the core functions when the context came from somewhere else
+  glewExperimental = GL_TRUE;
+  if (glewInit() != GLEW_OK) std::cout << "Error" << std::endl;
+
+  const GLubyte *renderer = glGetString(GL_RENDERER);
+  const GLubyte *version = glGetString(GL_VERSION);
+  if (!renderer || !version)
+  {
+    std::cout << "the OpenGL context is not usable, skipping" << std::endl;
+    glfwTerminate();
+    return EXIT_SKIPPED;
+  }
+
+  Results results;
+  results.renderer = (const char*)renderer;
+  results.version = (const char*)version;
+  results.frames = options.frames;
+
+  std::cout << "OpenGL version: " << results.version << ", " << results.renderer << std::endl;
+
+  {
+//    draw into our own target, a hidden window's default framebuffer doesnt have to keep any pixels
+    Texture target(WIDTH, HEIGHT, GL_RGBA8, GL_RGBA);
+    FrameBuffer frameBuffer;
+    frameBuffer.AttachColor(target);
+    if (frameBuffer.IsComplete()) frameBuffer.Bind();
+    GLCall(glViewport(0, 0, WIDTH, HEIGHT));
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+
+    VertexBuffer vb(QUAD_VERTICES, sizeof(QUAD_VERTICES));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+
+    VertexArray va;
+    va.AddBuffer(vb, layout);
+    IndexBuffer ib(QUAD_INDICES, 6);
+
+    Renderer renderer;
+    RenderQueue queue;
+    renderer.Clear();
+    glFinish();
+    results.startupMs = MillisecondsSince(processStart);
+
+    for (int run = 0; run < options.runs; run++)
+    {
+      const SceneResult scenes[] = {
+        RunQuads(queue, vb, layout, ib, options.frames),
+        RunTextures(renderer, va, ib, options.frames),
+        RunUniforms(renderer, va, ib, options.frames),
+        RunShaders(options.frames)
+      };
+      KeepBest(results.scenes, scenes, scenes + 4);
+
+      if (compare && !CompareResults(baseline, results, options.threshold, false)) break;
+      if (run + 1 < options.runs) std::cout << "run " << run + 1 << " of " << options.runs << " done, running the scenes again" << std::endl;
+    }
+
+    frameBuffer.Unbind();
+  }
+
+  glfwTerminate();
+
+  std::cout << std::setw(10) << "scene" << std::setw(10) << "draws" << std::setw(12) << "setup (ms)" << std::setw(12) << "frame (ms)" << std::setw(12) << "best (ms)"
+            << std::setw(14) << "draws/s" << std::setw(14) << "allocs/frame" << std::endl;
+  for (const SceneResult &scene : results.scenes)
+  {
+    std::cout << std::setw(10) << scene.name << std::setw(10) << scene.drawsPerFrame << std::fixed << std::setprecision(3)
+              << std::setw(12) << scene.setupMs << std::setw(12) << scene.cpuFrameMs << std::setw(12) << scene.minFrameMs
+              << std::setw(14) << std::setprecision(0) << scene.drawsPerSecond
+              << std::setw(14) << std::setprecision(1) << scene.allocationsPerFrame << std::endl;
+  }
+  std::cout << "startup " << std::setprecision(3) << results.startupMs << " ms" << std::endl;
+
+  if (!WriteResults(options.output, results))
+  {
+    std::cout << "cant write " << options.output << std::endl;
+    return EXIT_USAGE;
+  }
+
+  if (options.updateBaseline)
+  {
+    if (!WriteResults(options.baseline, results))
+    {
+      std::cout << "cant write " << options.baseline << std::endl;
+      return EXIT_USAGE;
+    }
+    std::cout << "baseline written to " << options.baseline << std::endl;
+    return 0;
+  }
+
+  if (!compare) return 0;
+
+  std::cout << std::endl << "against " << options.baseline << ", threshold " << std::setprecision(0) << options.threshold * 100.0 << "%" << std::endl;
+  const int regressions = CompareResults(baseline, results, options.threshold, true);
+
+  if (regressions)
+  {
+    std::cout << regressions << " regression" << (regressions > 1 ? "s" : "") << std::endl;
+    return EXIT_REGRESSION;
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+//
+//  ParticleBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  particles updated per millisecond, single threaded and across every core
+//  only the CPU side of the particle engine is used so no OpenGL context is needed
+//  lifetimes are spread over 0.5 to 1.5 seconds and the system runs past the longest one before the
+//  timing starts, so every measured frame kills and emits a share of the particles
+//
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ParticleSystem.hpp"
+#include "ThreadPool.hpp"
+
+static const int WARMUP_FRAMES = 90;
+static const int FRAMES = 120;
+
+/**
+ * returns particles per millisecond, for the update and for filling the instance stream
+ */
+static void Run(unsigned int particleCount, ThreadPool &pool, double &updateRate, double &fillRate)
+{
+  ParticleSystem particles(particleCount, pool);
+  particles.SetGravity(glm::vec2(0.0f, -9.8f));
+  
+  ParticleProps props;
+  props.position = glm::vec2(480.0f, 270.0f);
+  props.velocity = glm::vec2(0.0f, 50.0f);
+  props.velocityVariation = glm::vec2(100.0f, 100.0f);
+  props.size = 8.0f;
+  props.sizeVariation = 4.0f;
+  props.lifeTime = 1.0f;
+  props.lifeTimeVariation = 0.5f;
+  
+  std::vector<ParticleInstance> instances(particleCount);
+  
+  double updateTime = 0.0, fillTime = 0.0;
+  unsigned long long updated = 0;
+  
+  const float deltaTime = 1.0f / 60.0f;
+  for (int frame = -WARMUP_FRAMES; frame < FRAMES; frame++)
+  {
+//    top the system back up with whatever died last frame
+    particles.Emit(props, particleCount - particles.GetCount());
+    
+    if (frame < 0)
+    {
+      particles.Update(deltaTime);
+      continue;
+    }
+    
+    updated += particles.GetCount();
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    particles.Update(deltaTime);
+    auto middle = std::chrono::high_resolution_clock::now();
+    particles.FillInstances(instances.data(), particleCount);
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    updateTime += std::chrono::duration<double, std::milli>(middle - start).count();
+    fillTime += std::chrono::duration<double, std::milli>(end - middle).count();
+  }
+  
+  updateRate = updated / updateTime;
+  fillRate = updated / fillTime;
+}
+
+int main(void)
+{
+  ThreadPool single(1);
+  ThreadPool &all = ThreadPool::Get();
+  
+  std::cout << "threads: " << all.GetThreadCount() << std::endl;
+  std::cout << std::setw(12) << "particles"
+            << std::setw(22) << "update/ms (1 thread)" << std::setw(22) << "update/ms (all)"
+            << std::setw(22) << "fill/ms (1 thread)" << std::setw(22) << "fill/ms (all)" << std::endl;
+  
+  const unsigned int counts[] = { 100000, 1000000, 4000000 };
+  for (unsigned int count : counts)
+  {
+    double singleUpdate, singleFill, allUpdate, allFill;
+    Run(count, single, singleUpdate, singleFill);
+    Run(count, all, allUpdate, allFill);
+    
+    std::cout << std::setw(12) << count << std::fixed << std::setprecision(0)
+              << std::setw(22) << singleUpdate << std::setw(22) << allUpdate
+              << std::setw(22) << singleFill << std::setw(22) << allFill << std::endl;
+  }
+  
+  return 0;
+}
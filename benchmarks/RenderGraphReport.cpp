@@ -0,0 +1,155 @@
+//
+//  RenderGraphReport.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  compiles a sample shadow / main / bloom / composite frame and prints the pass order,
+//  the culled passes and the peak transient VRAM with and without aliasing
+//  Compile() doesnt touch OpenGL so no context is needed
+//  also checks that a target written, read, written again and read again keeps that order, exits with 1 if not
+//
+
+#include <GL/glew.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "RenderGraph.hpp"
+
+static double ToMB(unsigned long long bytes)
+{
+  return bytes / (1024.0 * 1024.0);
+}
+
+/**
+ * write X, read X, write X, read X - the first reader has to run before X is written again
+ */
+static bool CheckVersionOrder()
+{
+  RenderGraph graph;
+  RenderResource target = graph.CreateTexture("X", { 256, 256, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE });
+  
+  auto nothing = [](const RenderPassContext&) {};
+  const char *names[] = { "WriteA", "ReadA", "WriteB", "ReadB" };
+  
+  for (int i = 0; i < 4; i++)
+  {
+    graph.AddPass(names[i], [&](RenderPassBuilder &builder)
+    {
+      if (i % 2 == 0)
+      {
+        builder.Write(target);
+      }
+      else
+      {
+        builder.Read(target);
+        builder.HasSideEffects();
+      }
+    }, nothing);
+  }
+  
+  if (!graph.Compile()) return false;
+  
+  const std::vector<std::string> order = graph.GetExecutionOrder();
+  const bool ordered = order == std::vector<std::string>(names, names + 4);
+  
+  std::cout << "write / read / write / read:";
+  for (const auto &name : order) std::cout << " " << name;
+  std::cout << (ordered ? "" : "  WRONG ORDER") << std::endl << std::endl;
+  
+  return ordered;
+}
+
+int main(void)
+{
+  if (!CheckVersionOrder()) return 1;
+  
+  const int width = 1920, height = 1080;
+  
+  RenderGraph graph;
+  
+  RenderResource backbuffer = graph.ImportBackbuffer();
+  RenderResource shadowMap = graph.CreateTexture("ShadowMap", { 2048, 2048, GL_DEPTH_COMPONENT32F, GL_DEPTH_COMPONENT, GL_FLOAT });
+  RenderResource sceneColor = graph.CreateTexture("SceneColor", { width, height, GL_RGBA16F, GL_RGBA, GL_FLOAT });
+  RenderResource sceneDepth = graph.CreateTexture("SceneDepth", { width, height, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT });
+  RenderResource bright = graph.CreateTexture("Bright", { width / 2, height / 2, GL_RGBA16F, GL_RGBA, GL_FLOAT });
+  RenderResource blurTemp = graph.CreateTexture("BlurTemp", { width / 2, height / 2, GL_RGBA16F, GL_RGBA, GL_FLOAT });
+  RenderResource bloom = graph.CreateTexture("Bloom", { width / 2, height / 2, GL_RGBA16F, GL_RGBA, GL_FLOAT });
+  RenderResource debugView = graph.CreateTexture("DebugView", { width, height, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE });
+  
+  auto nothing = [](const RenderPassContext&) {};
+  
+//  declared out of order on purpose, the graph works the order out
+  graph.AddPass("Composite", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(sceneColor);
+    builder.Read(bloom);
+    builder.Write(backbuffer);
+  }, nothing);
+  
+  graph.AddPass("BlurVertical", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(blurTemp);
+    builder.Write(bloom);
+  }, nothing);
+  
+  graph.AddPass("Shadow", [&](RenderPassBuilder &builder)
+  {
+    builder.Write(shadowMap);
+  }, nothing);
+  
+  graph.AddPass("Main", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(shadowMap);
+    builder.Write(sceneColor);
+    builder.Write(sceneDepth);
+  }, nothing);
+  
+//  nothing reads the debug view so this one is culled
+  graph.AddPass("DepthDebug", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(sceneDepth);
+    builder.Write(debugView);
+  }, nothing);
+  
+  graph.AddPass("BrightPass", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(sceneColor);
+    builder.Write(bright);
+  }, nothing);
+  
+  graph.AddPass("BlurHorizontal", [&](RenderPassBuilder &builder)
+  {
+    builder.Read(bright);
+    builder.Write(blurTemp);
+  }, nothing);
+  
+  if (!graph.Compile()) return 1;
+  
+  std::cout << "execution order:";
+  for (const auto &name : graph.GetExecutionOrder()) std::cout << " " << name;
+  std::cout << std::endl << "culled:";
+  for (const auto &name : graph.GetCulledPasses()) std::cout << " " << name;
+  std::cout << std::endl << std::endl;
+  
+  const RenderResource targets[] = { shadowMap, sceneColor, sceneDepth, bright, blurTemp, bloom, debugView };
+  const char *names[] = { "ShadowMap", "SceneColor", "SceneDepth", "Bright", "BlurTemp", "Bloom", "DebugView" };
+  
+  std::cout << std::setw(12) << "target" << std::setw(12) << "texture" << std::endl;
+  for (int i = 0; i < 7; i++)
+  {
+    int physical = graph.GetPhysicalIndex(targets[i]);
+    std::cout << std::setw(12) << names[i] << std::setw(12) << (physical < 0 ? std::string("unused") : std::to_string(physical)) << std::endl;
+  }
+  
+  const RenderGraph::Statistics &stats = graph.GetStatistics();
+  std::cout << std::endl << std::fixed << std::setprecision(2)
+            << "passes: " << stats.passCount << " (" << stats.culledPasses << " culled)" << std::endl
+            << "transient targets: " << stats.transientTargets << " in " << stats.physicalTargets << " textures" << std::endl
+            << "peak transient VRAM without aliasing: " << ToMB(stats.transientBytes) << " MB" << std::endl
+            << "peak transient VRAM with aliasing:    " << ToMB(stats.aliasedBytes) << " MB" << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,163 @@
+//
+//  TextBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  glyphs laid out per frame and the atlas hit rate for the text subsystem
+//  glyphs come from a procedural rasterizer so neither a font file nor an OpenGL context is needed
+//  also checks that a space still gets its advance when the atlas is full, exits with 1 if not
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Font.hpp"
+
+static const int FRAMES = 120;
+static const int LABELS_PER_FRAME = 2000;
+static const int LABEL_LENGTH = 16;
+
+/**
+ * draws a ring whose size depends on the codepoint, just so every glyph is different
+ * space is the only empty glyph
+ */
+class ProceduralRasterizer : public GlyphRasterizer
+{
+public:
+  bool GetMetrics(unsigned int codepoint, GlyphBitmap &out) override
+  {
+    const int size = codepoint == ' ' ? 0 : 40;
+    out.width = size;
+    out.height = size;
+    out.bearingX = 0.0f;
+    out.bearingY = (float)size;
+    out.advance = 40.0f;
+    return true;
+  }
+  
+  bool Rasterize(unsigned int codepoint, GlyphBitmap &out) override
+  {
+    GetMetrics(codepoint, out);
+    const int size = out.width;
+    out.pixels.resize(size * size);
+    
+    const float outer = 10.0f + (codepoint % 10);
+    const float inner = outer - 4.0f - (codepoint % 3);
+    
+    for (int y = 0; y < size; y++)
+    {
+      for (int x = 0; x < size; x++)
+      {
+        float d = std::sqrt((x - size * 0.5f) * (x - size * 0.5f) + (y - size * 0.5f) * (y - size * 0.5f));
+        out.pixels[y * size + x] = (d < outer && d > inner) ? 255 : 0;
+      }
+    }
+    return true;
+  }
+  
+  float GetLineHeight() const override { return 40.0f; }
+};
+
+/**
+ * labels drawn from an alphabet of alphabetSize codepoints
+ * skewed so a few glyphs are common and the rest are rare, like real text
+ */
+static void Run(unsigned int alphabetSize, int atlasSize)
+{
+  Font font(std::make_unique<ProceduralRasterizer>(), atlasSize, 64, 8);
+  GlyphAtlas &atlas = font.GetAtlas();
+  
+  std::mt19937 random(1234);
+  std::exponential_distribution<float> skew(6.0f);
+  
+  std::vector<std::string> labels(LABELS_PER_FRAME);
+  std::vector<TextVertex> vertices;
+  vertices.reserve(LABELS_PER_FRAME * LABEL_LENGTH * 4);
+  
+  double totalTime = 0.0;
+  unsigned long long totalGlyphs = 0;
+  
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    for (auto &label : labels)
+    {
+      label.resize(LABEL_LENGTH);
+      for (auto &c : label)
+      {
+        unsigned int code = (unsigned int)(skew(random) * alphabetSize / 2) % alphabetSize;
+        c = (char)(33 + code);
+      }
+    }
+    
+//    the first frame fills the atlas so leave it out of the numbers
+    if (frame == 1) atlas.ResetStats();
+    
+    vertices.clear();
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    unsigned int glyphs = 0;
+    for (int i = 0; i < LABELS_PER_FRAME; i++)
+    {
+      glyphs += font.Layout(labels[i], 0.0f, i * 20.0f, 0.5f, 0xFFFFFFFF, vertices);
+    }
+    atlas.ClearDirty();
+    atlas.NextFrame();
+    auto end = std::chrono::high_resolution_clock::now();
+    
+    if (frame >= 1)
+    {
+      totalTime += std::chrono::duration<double, std::milli>(end - start).count();
+      totalGlyphs += glyphs;
+    }
+  }
+  
+  std::cout << std::setw(10) << atlasSize << std::setw(10) << (atlasSize / 64) * (atlasSize / 64)
+            << std::setw(10) << alphabetSize << std::fixed
+            << std::setw(16) << std::setprecision(0) << totalGlyphs / (double)(FRAMES - 1)
+            << std::setw(16) << std::setprecision(3) << totalTime / (FRAMES - 1)
+            << std::setw(16) << std::setprecision(0) << totalGlyphs / totalTime
+            << std::setw(12) << std::setprecision(2) << atlas.GetHitRate() * 100.0f << "%"
+            << std::setw(12) << atlas.GetDropped() << std::endl;
+}
+
+/**
+ * 4 slots all used this frame - the next glyph is dropped but a space needs no slot and keeps its advance
+ */
+static bool CheckEmptyGlyphWhenFull()
+{
+  GlyphAtlas atlas(128, 128, 64, 8);
+  ProceduralRasterizer rasterizer;
+  
+  for (unsigned int c = 'A'; c < 'A' + 4; c++) atlas.GetGlyph(c, rasterizer);
+  
+  const bool dropped = atlas.GetGlyph('E', rasterizer) == nullptr;
+  const AtlasGlyph *space = atlas.GetGlyph(' ', rasterizer);
+  const bool spaced = space && space->advance == 40.0f;
+  
+  std::cout << "full atlas: next glyph " << (dropped ? "dropped" : "NOT DROPPED") << ", space " << (spaced ? "kept its advance" : "LOST ITS ADVANCE") << std::endl << std::endl;
+  return dropped && spaced;
+}
+
+int main(void)
+{
+  if (!CheckEmptyGlyphWhenFull()) return 1;
+  
+  std::cout << "64px slots, " << LABELS_PER_FRAME << " labels of " << LABEL_LENGTH << " glyphs per frame" << std::endl;
+  std::cout << std::setw(10) << "atlas" << std::setw(10) << "slots" << std::setw(10) << "alphabet" << std::setw(16) << "glyphs/frame" << std::setw(16) << "ms/frame"
+            << std::setw(16) << "glyphs/ms" << std::setw(13) << "hit rate" << std::setw(12) << "dropped" << std::endl;
+  
+//  everything fits, then more distinct glyphs than slots so the LRU has to evict
+  Run(95, 1024);
+  Run(223, 1024);
+  Run(95, 512);
+  Run(223, 512);
+  
+  return 0;
+}
@@ -0,0 +1,194 @@
+//
+//  TextureStreamerBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  16 textures of 512x512 used at random sizes every frame under a few VRAM budgets
+//  every frame checks that the resident bytes stay under the budget, match the sum over the textures,
+//  and that no level a texture asked for this frame was evicted from under it
+//  the source images are written to the working directory and removed at the end
+//  exits with 1 if any of the checks failed
+//
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureStreamer.hpp"
+
+static const int FRAMES = 600;
+static const int TEXTURE_COUNT = 16;
+static const int TEXTURE_SIZE = 512;
+
+struct Result
+{
+  double updateMs = 0.0;
+  double uploadedMB = 0.0;
+  double evictedMB = 0.0;
+  double discardedMB = 0.0;     // loaded and thrown away before the upload
+  double budgetUsage = 0.0;     // average resident / budget
+  unsigned int fullyResident = 0;   // on the last frame
+  unsigned int failures = 0;
+};
+
+/**
+ * binary PPM, stb_image reads it and it needs no encoder
+ */
+static void WriteImage(const std::string &path, int seed)
+{
+  std::ofstream file(path, std::ios::binary);
+  file << "P6\n" << TEXTURE_SIZE << " " << TEXTURE_SIZE << "\n255\n";
+
+  std::vector<unsigned char> row(TEXTURE_SIZE * 3);
+  for (int y = 0; y < TEXTURE_SIZE; y++)
+  {
+    for (int x = 0; x < TEXTURE_SIZE; x++)
+    {
+      row[x * 3 + 0] = (unsigned char)(x + seed * 16);
+      row[x * 3 + 1] = (unsigned char)(y + seed * 32);
+      row[x * 3 + 2] = (unsigned char)((x ^ y) + seed);
+    }
+    file.write((const char*)row.data(), row.size());
+  }
+}
+
+static Result Run(const std::vector<std::string> &paths, unsigned long long budget)
+{
+  Result result;
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> used(0, 1);
+  std::uniform_int_distribution<int> size(0, 5);    // 16 to 512 pixels on screen
+
+  TextureStreamer streamer(budget);
+  std::vector<StreamedTexture*> textures;
+  for (const std::string &path : paths) textures.push_back(&streamer.Load(path));
+
+  std::vector<unsigned int> wanted(textures.size()), before(textures.size());
+
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    for (unsigned int i = 0; i < textures.size(); i++)
+    {
+      StreamedTexture &texture = *textures[i];
+      before[i] = texture.GetResidentLevel();
+      wanted[i] = texture.GetLevelCount();
+
+      if (!used(random)) continue;
+
+//      powers of two so the level RecordUse picks is exact, 512 on screen wants level 0
+      const int screenSize = 16 << size(random);
+      texture.RecordUse((float)screenSize);
+      wanted[i] = (unsigned int)std::log2((float)TEXTURE_SIZE / screenSize);
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    streamer.Update();
+    result.updateMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / FRAMES;
+
+    const TextureStreamerStatistics &stats = streamer.GetStatistics();
+
+    unsigned long long resident = 0;
+    for (unsigned int i = 0; i < textures.size(); i++)
+    {
+      resident += textures[i]->GetResidentBytes();
+
+//      had what it asked for before the update so it still has to have it after
+      if (before[i] <= wanted[i] && textures[i]->GetResidentLevel() > wanted[i])
+      {
+        std::cout << "frame " << frame << ": texture " << i << " lost level " << wanted[i] << " it used this frame" << std::endl;
+        result.failures++;
+      }
+    }
+
+    if (resident != stats.residentBytes)
+    {
+      std::cout << "frame " << frame << ": resident bytes " << stats.residentBytes << " but the textures hold " << resident << std::endl;
+      result.failures++;
+    }
+    if (stats.residentBytes > budget)
+    {
+      std::cout << "frame " << frame << ": resident bytes " << stats.residentBytes << " over the budget of " << budget << std::endl;
+      result.failures++;
+    }
+
+    result.budgetUsage += stats.GetBudgetUsage() / FRAMES;
+    result.fullyResident = stats.fullyResident;
+
+//    about a 60 Hz frame so the loader thread gets to run
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  result.uploadedMB = streamer.GetStatistics().totalUploadedBytes / (1024.0 * 1024.0);
+  result.evictedMB = streamer.GetStatistics().totalEvictedBytes / (1024.0 * 1024.0);
+  result.discardedMB = streamer.GetStatistics().totalDiscardedBytes / (1024.0 * 1024.0);
+  return result;
+}
+
+int main(void)
+{
+  if (!glfwInit())
+    return -1;
+
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  GLFWwindow* window = glfwCreateWindow(960, 540, "TextureStreamerBenchmark", NULL, NULL);
+  if (!window)
+  {
+    glfwTerminate();
+    return -1;
+  }
+
+  glfwMakeContextCurrent(window);
+
+  glewExperimental = GL_TRUE;
+  if (glewInit() != GLEW_OK) std::cout << "Error" << std::endl;
+  std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+
+  std::vector<std::string> paths;
+  for (int i = 0; i < TEXTURE_COUNT; i++)
+  {
+    paths.push_back("TextureStreamerBenchmark_" + std::to_string(i) + ".ppm");
+    WriteImage(paths.back(), i);
+  }
+
+  const double fullMB = TEXTURE_COUNT * TEXTURE_SIZE * TEXTURE_SIZE * 4 * 4.0 / 3.0 / (1024.0 * 1024.0);
+  std::cout << TEXTURE_COUNT << " textures of " << TEXTURE_SIZE << "x" << TEXTURE_SIZE << ", " << std::fixed << std::setprecision(1)
+            << fullMB << " MB with every level resident, " << FRAMES << " frames" << std::endl;
+  std::cout << std::setw(12) << "budget (MB)" << std::setw(14) << "update (ms)" << std::setw(16) << "uploaded (MB)"
+            << std::setw(16) << "evicted (MB)" << std::setw(16) << "discarded (MB)" << std::setw(14) << "budget use" << std::setw(16) << "fully resident"
+            << std::setw(12) << "failures" << std::endl;
+
+  unsigned int failures = 0;
+  const unsigned int budgets[] = { 4, 8, 16, 32 };
+  for (unsigned int megabytes : budgets)
+  {
+    const Result result = Run(paths, megabytes * 1024ull * 1024ull);
+    failures += result.failures;
+
+    std::cout << std::setw(12) << megabytes << std::setprecision(3) << std::setw(14) << result.updateMs
+              << std::setprecision(1) << std::setw(16) << result.uploadedMB << std::setw(16) << result.evictedMB << std::setw(16) << result.discardedMB
+              << std::setw(13) << result.budgetUsage * 100.0 << "%" << std::setw(16) << result.fullyResident
+              << std::setw(12) << result.failures << std::endl;
+  }
+
+  for (const std::string &path : paths) std::remove(path.c_str());
+
+  glfwTerminate();
+
+  return failures == 0 ? 0 : 1;
+}
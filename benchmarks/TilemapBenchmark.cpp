@@ -0,0 +1,185 @@
+//
+//  TilemapBenchmark.cpp
+//  OpenGLFramework
+//
+//  Created by Aybars Acar on 19/10/26.
+//
+//  a 4096x4096 map with a 1920x1080 camera panning across it and random edits every frame,
+//  the edits land inside the view so they all cost something
+//  per tile: every visible tile is turned into a quad and uploaded again every frame, one draw each
+//            like the sprite in Application.cpp
+//  chunked:  TilemapCache, chunks coming on screen are baked whole and only the edited rows of the
+//            others go up again, one draw per chunk
+//  CPU only, no OpenGL context needed
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "Tilemap.hpp"
+#include "TilemapCache.hpp"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+static const int FRAMES = 240;
+static const unsigned int MAP_SIZE = 4096;
+static const float TILE_PIXELS = 16.0f;
+static const float SCREEN_WIDTH = 1920.0f;
+static const float SCREEN_HEIGHT = 1080.0f;
+
+struct Result
+{
+  double ms = 0.0;
+  double uploadedKB = 0.0;
+  double rebuilt = 0.0;        // rows
+  double uploads = 0.0;
+  double drawCalls = 0.0;
+  double visibleChunks = 0.0;
+};
+
+/**
+ * view rectangle in tiles for the frame, panning right and a bit up
+ */
+static glm::vec2 CameraPosition(int frame)
+{
+  return glm::vec2(1000.0f + frame * 1.5f, 1000.0f + frame * 0.5f);
+}
+
+static glm::mat4 ViewProjection(int frame)
+{
+  const glm::vec2 camera = CameraPosition(frame);
+  const float width = SCREEN_WIDTH / TILE_PIXELS, height = SCREEN_HEIGHT / TILE_PIXELS;
+  return glm::ortho(camera.x, camera.x + width, camera.y, camera.y + height, -1.0f, 1.0f);
+}
+
+static void Edit(Tilemap &map, std::mt19937 &random, int frame, unsigned int edits)
+{
+  const glm::vec2 camera = CameraPosition(frame);
+  std::uniform_real_distribution<float> x(camera.x, camera.x + SCREEN_WIDTH / TILE_PIXELS);
+  std::uniform_real_distribution<float> y(camera.y, camera.y + SCREEN_HEIGHT / TILE_PIXELS);
+  std::uniform_int_distribution<unsigned int> tile(0, map.GetAtlas().GetTileCount());
+
+  for (unsigned int i = 0; i < edits; i++)
+  {
+    map.SetTile((unsigned int)x(random), (unsigned int)y(random), (unsigned short)tile(random));
+  }
+}
+
+static Result RunPerTile(Tilemap &map, unsigned int edits)
+{
+  Result result;
+  std::mt19937 random(7);
+  std::vector<float> vertices;
+
+  for (int frame = 0; frame < FRAMES; frame++)
+  {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    Edit(map, random, frame, edits);
+
+//    every tile in view, a quad each
+    const glm::vec2 camera = CameraPosition(frame);
+    const unsigned int beginX = (unsigned int)camera.x, endX = (unsigned int)(camera.x + SCREEN_WIDTH / TILE_PIXELS) + 1;
+    const unsigned int beginY = (unsigned int)camera.y, endY = (unsigned int)(camera.y + SCREEN_HEIGHT / TILE_PIXELS) + 1;
+
+    vertices.clear();
+    unsigned int draws = 0;
+    for (unsigned int y = beginY; y < endY; y++)
+    {
+      for (unsigned int x = beginX; x < endX; x++)
+      {
+        const unsigned int index = map.GetTile(x, y) - 1u;
+        if (index >= map.GetAtlas().GetTileCount()) continue;
+
+        const glm::vec4 &uv = map.GetAtlas().GetUV(index);
+        const float quad[] = {
+          (float)x, (float)y, uv.x, uv.y,   (float)x + 1, (float)y, uv.z, uv.y,
+          (float)x + 1, (float)y + 1, uv.z, uv.w,   (float)x, (float)y + 1, uv.x, uv.w
+        };
+        vertices.insert(vertices.end(), quad, quad + 16);
+        draws++;
+      }
+    }
+
+    result.ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / FRAMES;
+    result.uploadedKB += vertices.size() * sizeof(float) / 1024.0 / FRAMES;
+    result.drawCalls += (double)draws / FRAMES;
+  }
+
+  return result;
+}
+
+static Result RunChunked(Tilemap &map, unsigned int edits)
+{
+  Result result;
+  std::mt19937 random(7);
+  TilemapCache cache(map);
+
+  for (int frame = -1; frame < FRAMES; frame++)
+  {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+//    frame -1 bakes the first view so the table is only the steady state
+    if (frame >= 0) Edit(map, random, frame, edits);
+    cache.Update(ViewProjection(std::max(frame, 0)));
+
+    if (frame < 0) continue;
+
+    const TilemapStatistics &stats = cache.GetStatistics();
+    result.ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / FRAMES;
+    result.uploadedKB += stats.uploadedBytes / 1024.0 / FRAMES;
+    result.rebuilt += (double)(stats.rebuiltRows + stats.bakedChunks * map.GetChunkSize()) / FRAMES;
+    result.uploads += (double)stats.uploads / FRAMES;
+    result.drawCalls += (double)stats.drawCalls / FRAMES;
+    result.visibleChunks += (double)stats.visibleChunks / FRAMES;
+  }
+
+  return result;
+}
+
+int main(void)
+{
+//  a 256x256 atlas of 16x16 tiles
+  const TileAtlas atlas(256, 256, 16, 16);
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<unsigned int> tile(0, atlas.GetTileCount());
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  Tilemap perTileMap(MAP_SIZE, MAP_SIZE, atlas);
+  for (unsigned int y = 0; y < MAP_SIZE; y++)
+  {
+    for (unsigned int x = 0; x < MAP_SIZE; x++)
+    {
+      perTileMap.SetTile(x, y, (unsigned short)tile(random));
+    }
+  }
+  Tilemap chunkedMap = perTileMap;
+  const double fillMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+  std::cout << MAP_SIZE << "x" << MAP_SIZE << " tiles in " << MAP_SIZE / perTileMap.GetChunkSize() << "x" << MAP_SIZE / perTileMap.GetChunkSize()
+            << " chunks of " << perTileMap.GetChunkSize() << ", " << (int)SCREEN_WIDTH << "x" << (int)SCREEN_HEIGHT << " view of "
+            << (int)TILE_PIXELS << "px tiles, filled in " << std::fixed << std::setprecision(0) << fillMs << " ms" << std::endl;
+
+  std::cout << std::setw(12) << "edits/frame" << std::setw(10) << "path" << std::setw(12) << "frame (ms)" << std::setw(14) << "upload (KB)"
+            << std::setw(12) << "draws" << std::setw(10) << "uploads" << std::setw(14) << "rows baked" << std::setw(10) << "chunks" << std::endl;
+
+  const unsigned int counts[] = { 0, 10, 100, 1000 };
+  for (unsigned int edits : counts)
+  {
+    const Result perTile = RunPerTile(perTileMap, edits);
+    const Result chunked = RunChunked(chunkedMap, edits);
+
+    std::cout << std::setw(12) << edits << std::setw(10) << "per tile" << std::setprecision(3) << std::setw(12) << perTile.ms
+              << std::setprecision(1) << std::setw(14) << perTile.uploadedKB << std::setw(12) << perTile.drawCalls << std::endl;
+    std::cout << std::setw(12) << "" << std::setw(10) << "chunked" << std::setprecision(3) << std::setw(12) << chunked.ms
+              << std::setprecision(1) << std::setw(14) << chunked.uploadedKB << std::setw(12) << chunked.drawCalls
+              << std::setw(10) << chunked.uploads << std::setw(14) << chunked.rebuilt << std::setw(10) << chunked.visibleChunks << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+struct ObjectData
+{
+  mat4 transform;
+  vec4 boundingSphere;
+  uint indexCount;
+  uint firstIndex;
+  int baseVertex;
+  uint padding;
+};
+
+struct DrawCommand
+{
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Objects
+{
+  ObjectData objects[];
+};
+
+layout(std430, binding = 1) writeonly buffer Commands
+{
+  DrawCommand commands[];
+};
+
+uniform vec4 u_FrustumPlanes[6];
+uniform uint u_ObjectCount;
+
+void main()
+{
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= u_ObjectCount)
+    return;
+  
+  ObjectData object = objects[id];
+  
+  vec3 center = (object.transform * vec4(object.boundingSphere.xyz, 1.0)).xyz;
+  float scale = max(max(length(object.transform[0].xyz), length(object.transform[1].xyz)), length(object.transform[2].xyz));
+  float radius = object.boundingSphere.w * scale;
+  
+  bool visible = true;
+  for (int i = 0; i < 6; i++)
+  {
+    visible = visible && (dot(u_FrustumPlanes[i].xyz, center) + u_FrustumPlanes[i].w >= -radius);
+  }
+  
+  // culled objects keep their slot with 0 instances so baseInstance stays the object id
+  commands[id] = DrawCommand(object.indexCount, visible ? 1u : 0u, object.firstIndex, object.baseVertex, id);
+}
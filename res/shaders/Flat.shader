@@ -0,0 +1,26 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+
+uniform mat4 u_MVP;
+uniform vec2 u_Offset;
+
+void main()
+{
+  gl_Position = u_MVP * (position + vec4(u_Offset, 0.0, 0.0));
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+uniform vec4 u_Color;
+uniform vec4 u_Tint;
+
+void main()
+{
+  color = u_Color * u_Tint;
+}
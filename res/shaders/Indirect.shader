@@ -0,0 +1,47 @@
+#shader vertex
+#version 430 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in uint objectID;
+
+struct ObjectData
+{
+  mat4 transform;
+  vec4 boundingSphere;
+  uint indexCount;
+  uint firstIndex;
+  int baseVertex;
+  uint padding;
+};
+
+layout(std430, binding = 0) readonly buffer Objects
+{
+  ObjectData objects[];
+};
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+  gl_Position = u_ViewProjection * objects[objectID].transform * position;
+  v_TexCoord = texCoord;
+}
+
+
+#shader fragment
+#version 430 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+  vec4 texColor = texture(u_Texture, v_TexCoord);
+  color = texColor;
+}
@@ -0,0 +1,77 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texCoord;
+
+out vec3 v_ViewPosition;
+out vec3 v_ViewNormal;
+out vec2 v_TexCoord;
+
+uniform mat4 u_Model;
+uniform mat4 u_View;
+uniform mat4 u_Projection;
+
+void main()
+{
+  vec4 viewPosition = u_View * u_Model * vec4(position, 1.0);
+  
+  gl_Position = u_Projection * viewPosition;
+  v_ViewPosition = viewPosition.xyz;
+  v_ViewNormal = mat3(u_View * u_Model) * normal;   // fine as long as the model isnt scaled unevenly
+  v_TexCoord = texCoord;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_ViewPosition;
+in vec3 v_ViewNormal;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+uniform vec3 u_Ambient;
+
+// filled in by ClusteredLighting
+uniform usamplerBuffer u_Clusters;      // offset, count
+uniform usamplerBuffer u_LightIndices;
+uniform samplerBuffer u_Lights;         // view space position + radius, colour
+uniform vec3 u_ClusterGrid;             // tiles x, tiles y, slices
+uniform vec2 u_ScreenSize;
+uniform float u_Near;
+uniform float u_Far;
+
+void main()
+{
+  // same cluster maths as LightClusterBuilder
+  float depth = -v_ViewPosition.z;
+  float slice = clamp(floor(log(depth / u_Near) / log(u_Far / u_Near) * u_ClusterGrid.z), 0.0, u_ClusterGrid.z - 1.0);
+  vec2 tile = min(floor(gl_FragCoord.xy / u_ScreenSize * u_ClusterGrid.xy), u_ClusterGrid.xy - 1.0);
+  int cluster = int(tile.x + tile.y * u_ClusterGrid.x + slice * u_ClusterGrid.x * u_ClusterGrid.y);
+  
+  uvec2 range = texelFetch(u_Clusters, cluster).xy;
+  
+  vec3 N = normalize(v_ViewNormal);
+  vec3 lighting = u_Ambient;
+  
+  // only the lights that touch this cluster
+  for (uint i = 0u; i < range.y; i++)
+  {
+    int light = int(texelFetch(u_LightIndices, int(range.x + i)).r);
+    vec4 positionRadius = texelFetch(u_Lights, light * 2);
+    vec3 lightColor = texelFetch(u_Lights, light * 2 + 1).rgb;
+    
+    vec3 L = positionRadius.xyz - v_ViewPosition;
+    float distance = length(L);
+    float attenuation = clamp(1.0 - distance / positionRadius.w, 0.0, 1.0);
+    
+    lighting += lightColor * max(dot(N, L / distance), 0.0) * attenuation * attenuation;
+  }
+  
+  vec4 texColor = texture(u_Texture, v_TexCoord);
+  color = vec4(texColor.rgb * lighting, texColor.a);
+}
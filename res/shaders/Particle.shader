@@ -0,0 +1,35 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 instance;    // x, y, size, alpha
+
+out vec2 v_TexCoord;
+out float v_Alpha;
+
+uniform mat4 u_MVP;
+
+void main()
+{
+  gl_Position = u_MVP * vec4(instance.xy + position * instance.z, 0.0, 1.0);
+  v_TexCoord = texCoord;
+  v_Alpha = instance.w;
+}
+
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in float v_Alpha;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+  vec4 texColor = texture(u_Texture, v_TexCoord);
+  color = vec4(texColor.rgb, texColor.a * v_Alpha);
+}